@@ -4,6 +4,7 @@
 */
 
 #include <Std/Forward.hpp>
+#include <Std/Span.hpp>
 
 #include <Kernel/ABI.hpp>
 
@@ -43,23 +44,9 @@ int strcmp(const char *a, const char *b)
 }
 
 extern "C"
-int memcmp(const void *a_, const void *b_, usize n)
+int memcmp(const void *a, const void *b, usize n)
 {
-    const u8 *a = (const u8*)a_;
-    const u8 *b = (const u8*)b_;
-
-    for (usize i = 0; i < n; ++i) {
-        if (*a < *b)
-            return -1;
-
-        if (*a > *b)
-            return 1;
-
-        ++a;
-        ++b;
-    }
-
-    return 0;
+    return Std::compare_bytes(a, b, n);
 }
 
 extern "C"
@@ -2,6 +2,7 @@
 #include <Kernel/FileSystem/MemoryFileSystem.hpp>
 #include <Kernel/FileSystem/FileSystem.hpp>
 #include <Kernel/ConsoleDevice.hpp>
+#include <Kernel/HeapDevice.hpp>
 
 namespace Kernel
 {
@@ -18,5 +19,11 @@ namespace Kernel
         tty_file.m_mode = ModeFlags::Device;
         tty_file.m_device_id = 0x00010001;
         dev_directory.m_entries.set("tty", &tty_file);
+
+        add_device(0x00010002, *new HeapFile);
+        auto& heap_file = *new MemoryFile;
+        heap_file.m_mode = ModeFlags::Device;
+        heap_file.m_device_id = 0x00010002;
+        dev_directory.m_entries.set("heap", &heap_file);
     }
 }
@@ -14,7 +14,10 @@ namespace Kernel::FileSystem
             auto *directory = dynamic_cast<VirtualDirectory*>(file);
             ASSERT(directory != nullptr);
 
-            file = directory->m_entries.get_opt(component).must();
+            VirtualFile **entry = directory->m_entries.find(component);
+            ASSERT(entry != nullptr);
+
+            file = *entry;
         }
 
         ASSERT(file != nullptr);
@@ -33,18 +36,49 @@ namespace Kernel::FileSystem
             if (directory == nullptr)
                 return ENOTDIR;
 
-            auto file_opt = directory->m_entries.get_opt(component);
+            VirtualFile **entry = directory->m_entries.find(component);
 
-            if (!file_opt.is_valid())
+            if (entry == nullptr)
                 return ENOENT;
 
-            file = file_opt.value();
+            file = *entry;
         }
 
         ASSERT(file != nullptr);
         return file;
     }
 
+    KernelResult<VirtualFile*> try_lookup(PathView path, PathView working_directory)
+    {
+        VirtualFile *file = &MemoryFileSystem::the().root();
+        int error = 0;
+
+        PathView::for_each_resolved_component(working_directory, path, [&](StringView component) {
+            auto *directory = dynamic_cast<VirtualDirectory*>(file);
+
+            if (directory == nullptr) {
+                error = ENOTDIR;
+                return IterationDecision::Break;
+            }
+
+            VirtualFile **entry = directory->m_entries.find(component);
+
+            if (entry == nullptr) {
+                error = ENOENT;
+                return IterationDecision::Break;
+            }
+
+            file = *entry;
+            return IterationDecision::Continue;
+        });
+
+        if (error != 0)
+            return error;
+
+        ASSERT(file != nullptr);
+        return file;
+    }
+
     static HashMap<u32, VirtualFile*> devices;
 
     void add_device(u32 device, VirtualFile& file)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Std/Path.hpp>
+#include <Std/PathView.hpp>
 
 #include <Kernel/FileSystem/VirtualFileSystem.hpp>
 
@@ -11,6 +12,9 @@ namespace Kernel::FileSystem
 
     KernelResult<VirtualFile*> try_lookup(Path);
 
+    // Relative paths are resolved in 'working_directory', this does not allocate.
+    KernelResult<VirtualFile*> try_lookup(PathView, PathView working_directory = "/");
+
     void add_device(u32 device, VirtualFile&);
     VirtualFileHandle& create_handle_for_device(u32 device);
 }
@@ -33,14 +33,17 @@ namespace Kernel
         auto *end = reinterpret_cast<const FlashDirectoryInfo*>(info.m_data + info.st_size);
 
         for(auto *entry = begin; entry != end; ++entry) {
+            // The name lives in flash, it does not have to be copied into RAM.
+            auto name = ImmutableString::from_static(entry->m_name);
+
             if ((entry->m_info->st_mode & Kernel::ModeFlags::Format) == Kernel::ModeFlags::Directory) {
                 auto& new_directory = *new FlashDirectory { *entry->m_info };
                 new_directory.m_entries.set("..", this);
 
-                m_entries.set(entry->m_name, &new_directory);
+                m_entries.set(name, &new_directory);
             } else {
                 VERIFY((entry->m_info->st_mode & Kernel::ModeFlags::Format) == Kernel::ModeFlags::Regular);
-                m_entries.set(entry->m_name, new FlashFile { *entry->m_info });
+                m_entries.set(name, new FlashFile { *entry->m_info });
             }
         }
     }
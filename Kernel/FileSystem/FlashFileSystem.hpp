@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Std/Singleton.hpp>
+#include <Std/ObjectPool.hpp>
 #include <Std/Span.hpp>
 
 #include <Kernel/FileSystem/VirtualFileSystem.hpp>
@@ -48,7 +49,7 @@ namespace Kernel
         ReadonlyBytes m_data;
     };
 
-    class FlashFileHandle final : public VirtualFileHandle {
+    class FlashFileHandle final : public VirtualFileHandle, public PoolAllocated<FlashFileHandle> {
     public:
         explicit FlashFileHandle(FlashFile& file)
             : m_file(file)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Std/Singleton.hpp>
+#include <Std/ObjectPool.hpp>
 
 #include <Kernel/FileSystem/VirtualFileSystem.hpp>
 #include <Kernel/Interface/Types.hpp>
@@ -60,7 +61,7 @@ namespace Kernel
         Vector<u8> m_data;
     };
 
-    class MemoryFileHandle final : public VirtualFileHandle {
+    class MemoryFileHandle final : public VirtualFileHandle, public PoolAllocated<MemoryFileHandle> {
     public:
         explicit MemoryFileHandle(MemoryFile& file)
             : m_file(file)
@@ -104,7 +105,7 @@ namespace Kernel
         VirtualFileHandle& create_handle_impl() override;
     };
 
-    class MemoryDirectoryHandle final : public VirtualFileHandle {
+    class MemoryDirectoryHandle final : public VirtualFileHandle, public PoolAllocated<MemoryDirectoryHandle> {
     public:
         explicit MemoryDirectoryHandle(MemoryDirectory& directory)
             : m_iterator(directory.m_entries.iter())
@@ -7,4 +7,6 @@ namespace Kernel
     using namespace Std;
 
     class Thread;
+    struct TypeErasedValue;
+    struct FullRegisterContext;
 }
@@ -1,14 +1,28 @@
+#include <Std/Format.hpp>
+
 #include <Kernel/GlobalMemoryAllocator.hpp>
 #include <Kernel/PageAllocator.hpp>
 #include <Kernel/KernelMutex.hpp>
 #include <Kernel/HandlerMode.hpp>
 
+#include <hardware/timer.h>
+
 namespace Kernel
 {
     GlobalMemoryAllocator::GlobalMemoryAllocator()
         : MemoryAllocator(allocate_heap())
     {
+        if (trace_global_memory_allocator) {
+            m_trace_range = PageAllocator::the().allocate(trace_buffer_power).must();
+
+            Bytes bytes = m_trace_range->bytes();
+            set_trace_buffer({ reinterpret_cast<MemoryTraceRecord*>(bytes.data()), bytes.size() / sizeof(MemoryTraceRecord) });
+        }
 
+        if (account_global_memory_allocator) {
+            m_call_site_range = PageAllocator::the().allocate(power_of_two(round_to_power_of_two(call_site_table_size * sizeof(CallSite)))).must();
+            set_call_site_table({ reinterpret_cast<CallSite*>(m_call_site_range->data()), call_site_table_size });
+        }
     }
 
     void GlobalMemoryAllocator::set_mutex_enabled(bool enabled)
@@ -52,6 +66,98 @@ namespace Kernel
 
         return retval;
     }
+
+    bool GlobalMemoryAllocator::try_expand(u8 *pointer, usize size, bool debug_override, void *address)
+    {
+        VERIFY(Kernel::is_executing_in_thread_mode());
+
+        malloc_mutex.lock();
+        bool retval = MemoryAllocator::try_expand(pointer, size, debug_override, address);
+        malloc_mutex.unlock();
+
+        return retval;
+    }
+
+    usize GlobalMemoryAllocator::drain_trace(Span<MemoryTraceRecord> output)
+    {
+        VERIFY(Kernel::is_executing_in_thread_mode());
+
+        malloc_mutex.lock();
+        usize count = trace_buffer().drain(output);
+        malloc_mutex.unlock();
+
+        return count;
+    }
+
+    void GlobalMemoryAllocator::dump_trace()
+    {
+        VERIFY(Kernel::is_executing_in_thread_mode());
+
+        MemoryTraceRecord records[8];
+
+        malloc_mutex.lock();
+        usize remaining = trace_buffer().size();
+        malloc_mutex.unlock();
+
+        // 'dbgln' does not allocate, but printing is slow and every allocation would have to wait for the mutex.
+        // Only the records that were there when we started are printed, otherwise this might never finish.
+        while (remaining > 0) {
+            usize count = drain_trace({ records, min<usize>(remaining, 8) });
+            if (count == 0)
+                break;
+
+            for (usize index = 0; index < count; ++index)
+                dump_trace_record(records[index]);
+
+            remaining -= count;
+        }
+    }
+
+    void GlobalMemoryAllocator::dump_call_sites()
+    {
+        if (!account_global_memory_allocator) {
+            dbgln("[GlobalMemoryAllocator] Call sites are not accounted, enable 'account_global_memory_allocator'");
+            return;
+        }
+
+        VERIFY(Kernel::is_executing_in_thread_mode());
+
+        dbgln("call sites:");
+
+        CallSite copies[8];
+        usize live_bytes = 0;
+        usize unaccounted = 0;
+
+        usize index = 0;
+        for (;;) {
+            usize count = 0;
+
+            malloc_mutex.lock();
+            Span<CallSite> table = call_sites();
+            for (; index < table.size() && count < 8; ++index) {
+                if (table[index].m_caller != 0)
+                    copies[count++] = table[index];
+            }
+            unaccounted = unaccounted_allocations();
+            bool done = index >= table.size();
+            malloc_mutex.unlock();
+
+            for (usize copy = 0; copy < count; ++copy) {
+                dump_call_site(copies[copy]);
+                live_bytes += copies[copy].m_live_bytes;
+            }
+
+            if (done)
+                break;
+        }
+
+        dbgln("  {} bytes accounted, {} allocations not accounted", live_bytes, unaccounted);
+    }
+
+    u32 GlobalMemoryAllocator::trace_timestamp()
+    {
+        return time_us_32();
+    }
 }
 
 void* operator new(usize size)
@@ -8,6 +8,14 @@
 
 namespace Kernel
 {
+    // Record every allocation in a binary trace buffer, use 'GlobalMemoryAllocator::dump_trace' to print it.
+    constexpr bool trace_global_memory_allocator = false;
+    constexpr usize trace_buffer_power = power_of_two(4 * KiB);
+
+    // Account every allocation to its call site, reading '/dev/heap' prints the table.
+    constexpr bool account_global_memory_allocator = false;
+    constexpr usize call_site_table_size = 64;
+
     class GlobalMemoryAllocator final
         : public Singleton<GlobalMemoryAllocator>
         , public MemoryAllocator
@@ -16,14 +24,27 @@ namespace Kernel
         u8* allocate(usize, bool debug_override = true, void *address = nullptr) override;
         void deallocate(u8*, bool debug_override = true, void *address = nullptr) override;
         u8* reallocate(u8*, usize, bool debug_override = true, void *address = nullptr) override;
+        bool try_expand(u8*, usize, bool debug_override = true, void *address = nullptr) override;
+
+        // Removes the oldest records from the trace buffer, this can be used by a thread that collects them.
+        usize drain_trace(Span<MemoryTraceRecord>);
+        void dump_trace() override;
+
+        // The entries are copied a few at a time while holding the mutex, they are printed without holding it.
+        void dump_call_sites() override;
 
         void set_mutex_enabled(bool enabled);
 
+    protected:
+        u32 trace_timestamp() override;
+
     private:
         friend Singleton<GlobalMemoryAllocator>;
         GlobalMemoryAllocator();
 
         Optional<OwnedPageRange> m_heap;
+        Optional<OwnedPageRange> m_trace_range;
+        Optional<OwnedPageRange> m_call_site_range;
 
         Bytes allocate_heap();
     };
@@ -0,0 +1,17 @@
+#include <Kernel/HeapDevice.hpp>
+#include <Kernel/GlobalMemoryAllocator.hpp>
+
+namespace Kernel
+{
+    KernelResult<usize> HeapFileHandle::read(Bytes bytes)
+    {
+        // The output goes directly to the console, thus there is nothing to read.
+        GlobalMemoryAllocator::the().dump_call_sites();
+        return 0;
+    }
+
+    KernelResult<usize> HeapFileHandle::write(ReadonlyBytes bytes)
+    {
+        VERIFY_NOT_REACHED();
+    }
+}
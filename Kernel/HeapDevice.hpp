@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Kernel/FileSystem/VirtualFileSystem.hpp>
+
+namespace Kernel {
+    // Reading from this device prints the call sites of the kernel heap, e.g. 'cat /dev/heap' in the shell.
+    class HeapFileHandle final : public VirtualFileHandle
+    {
+    public:
+        explicit HeapFileHandle(VirtualFile& file)
+            : m_file(file)
+        {
+        }
+
+        KernelResult<usize> read(Bytes bytes) override;
+        KernelResult<usize> write(ReadonlyBytes bytes) override;
+
+        VirtualFile& file() override { return m_file; }
+
+    private:
+        VirtualFile& m_file;
+    };
+
+    class HeapFile final : public VirtualFile
+    {
+    public:
+        VirtualFileHandle& create_handle_impl() override
+        {
+            return *new HeapFileHandle { *this };
+        }
+
+        void truncate() override
+        {
+            VERIFY_NOT_REACHED();
+        }
+    };
+}
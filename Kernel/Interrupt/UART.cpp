@@ -1,44 +1,16 @@
+#include <Std/Format.hpp>
+
 #include <Kernel/Interrupt/UART.hpp>
 #include <Kernel/HandlerMode.hpp>
+#include <Kernel/Synchronization/MaskedInterruptGuard.hpp>
 
 #include <hardware/irq.h>
 #include <hardware/uart.h>
 #include <hardware/gpio.h>
 #include <hardware/structs/uart.h>
-#include <hardware/dma.h>
 
 namespace Kernel::Interrupt
 {
-    void UART::configure_dma()
-    {
-        const u32 channel = 0;
-
-        // FIXME: Claim
-
-        auto config = dma_channel_get_default_config(channel);
-        channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
-
-        // The read address is the address of the UART data register which is constant
-        channel_config_set_read_increment(&config, false);
-
-        // Write into a ringbuffer with '2^buffer_power=buffer_size' elements
-        channel_config_set_write_increment(&config, true);
-        channel_config_set_ring(&config, true, buffer_power);
-
-        // The UART signals when data is avaliable
-        channel_config_set_dreq(&config, DREQ_UART0_RX);
-
-        // Transmit '2^32 - 1' symbols, this should suffice for any practical case,
-        // otherwise, the channel could be triggered again
-        dma_channel_configure(
-            channel,
-            &config,
-            m_input_buffer->data(),
-            &uart0_hw->dr,
-            UINT32_MAX,
-            true);
-    }
-
     void UART::configure_uart()
     {
         uart_init(uart0, 115200);
@@ -52,23 +24,43 @@ namespace Kernel::Interrupt
 
     UART::UART()
     {
-        m_input_buffer = PageAllocator::the().allocate(buffer_power).must();
-
         configure_uart();
-        configure_dma();
+
+        irq_set_exclusive_handler(UART0_IRQ, handle_interrupt);
+        irq_set_enabled(UART0_IRQ, true);
+
+        // Only interrupt when data is received, writes are polled.
+        uart_set_irq_enables(uart0, true, false);
     }
 
-    KernelResult<usize> UART::read(Bytes bytes)
+    void UART::handle_interrupt()
     {
-        MaskedInterruptGuard interrupt_guard;
+        UART& uart = UART::the();
 
-        usize index;
-        for (index = 0; index < min(input_buffer_size(), bytes.size()); ++index) {
-            bytes[index] = m_input_buffer->bytes()[input_buffer_consume_offset()];
-            ++m_input_buffer_consume_offset_raw;
-        }
+        // Drain the hardware FIFO, it is 32 bytes deep.
+        u8 buffer[32];
+        usize count = 0;
+        while (count < sizeof(buffer) && uart_is_readable(uart0))
+            buffer[count++] = static_cast<u8>(uart_getc(uart0));
 
-        return index;
+        usize pushed = uart.m_input_buffer.push_n(ReadonlyBytes { buffer, count });
+
+        // If nobody is reading, the oldest input is kept and the rest is dropped.
+        uart.m_dropped_input_bytes += count - pushed;
+
+        if (debug_uart && count != pushed)
+            dbgln("[UART::handle_interrupt] Dropped {} bytes of input", u32(count - pushed));
+    }
+
+    KernelResult<usize> UART::read(Bytes bytes)
+    {
+        // The ring buffer allows a single consumer only, but multiple threads can read from the console at the same
+        // time.  The interrupt handler can keep pushing while we copy.
+        m_read_mutex.lock();
+        usize count = m_input_buffer.pop_n(bytes);
+        m_read_mutex.unlock();
+
+        return count;
     }
 
     KernelResult<usize> UART::write(ReadonlyBytes bytes)
@@ -85,21 +77,4 @@ namespace Kernel::Interrupt
 
         return bytes.size();
     }
-
-    usize UART::input_buffer_consume_offset()
-    {
-        return m_input_buffer_consume_offset_raw % buffer_size;
-    }
-
-    usize UART::input_buffer_avaliable_offset()
-    {
-        VERIFY(dma_channel_hw_addr(input_dma_channel)->write_addr >= uptr(m_input_buffer->data()));
-        return dma_channel_hw_addr(input_dma_channel)->write_addr - uptr(m_input_buffer->data());
-    }
-
-    usize UART::input_buffer_size()
-    {
-        FIXME_ASSERT(input_buffer_avaliable_offset() >= input_buffer_consume_offset());
-        return input_buffer_avaliable_offset() - input_buffer_consume_offset();
-    }
 }
@@ -2,11 +2,11 @@
 
 #include <Std/Singleton.hpp>
 #include <Std/Span.hpp>
-#include <Std/CircularQueue.hpp>
+#include <Std/RingBuffer.hpp>
 
 #include <Kernel/Forward.hpp>
 #include <Kernel/Result.hpp>
-#include <Kernel/PageAllocator.hpp>
+#include <Kernel/KernelMutex.hpp>
 
 namespace Kernel::Interrupt
 {
@@ -20,22 +20,21 @@ namespace Kernel::Interrupt
         KernelResult<usize> write(ReadonlyBytes);
 
         static constexpr usize buffer_size = 1 * KiB;
-        static constexpr usize buffer_power = power_of_two(buffer_size);
-
-        static constexpr u32 input_dma_channel = 0;
 
     private:
-        Optional<OwnedPageRange> m_input_buffer;
-        usize m_input_buffer_consume_offset_raw = 0;
+        // The interrupt handler is the producer and 'read' is the consumer.
+        RingBuffer<u8, buffer_size> m_input_buffer;
+
+        // Serializes the threads that call 'read'.
+        KernelMutex m_read_mutex;
 
-        usize input_buffer_consume_offset();
-        usize input_buffer_avaliable_offset();
-        usize input_buffer_size();
+        usize m_dropped_input_bytes = 0;
 
         friend Singleton<UART>;
         UART();
 
-        void configure_dma();
         void configure_uart();
+
+        static void handle_interrupt();
     };
 }
@@ -1,10 +1,11 @@
 #pragma once
 
-#include <Std/CircularQueue.hpp>
+#include <Std/IntrusiveList.hpp>
 #include <Std/RefPtr.hpp>
 
 #include <Kernel/Forward.hpp>
 #include <Kernel/Threads/Scheduler.hpp>
+#include <Kernel/Synchronization/MaskedInterruptGuard.hpp>
 
 namespace Kernel
 {
@@ -101,7 +102,7 @@ namespace Kernel
         volatile bool m_enabled = true;
 
         RefPtr<Thread> m_holding_thread;
-        CircularQueue<RefPtr<Thread>, 16> m_waiting_threads;
+        IntrusiveRefList<Thread, &Thread::m_queue_node> m_waiting_threads;
     };
 
     extern KernelMutex dbgln_mutex;
@@ -1,3 +1,5 @@
+#include <Std/Format.hpp>
+
 #include <Kernel/PageAllocator.hpp>
 #include <Kernel/KernelMutex.hpp>
 #include <Kernel/HandlerMode.hpp>
@@ -22,30 +24,16 @@ namespace Kernel
     }
 
     PageAllocator::PageAllocator()
+        : m_buddies(reinterpret_cast<uptr>(__pico_ram_start))
     {
-        for (auto& block : m_blocks.span().iter()) {
-            block = nullptr;
-        }
-
         // My custom linker script will allocate the first 8 KiB of RAM for statup.
         // The rest can be managed by this page allocator.
 
-        m_blocks[power_of_two(128 * KiB)] = reinterpret_cast<Block*>(__pico_ram_start + 128 * KiB);
-        m_blocks[power_of_two(64 * KiB)] = reinterpret_cast<Block*>(__pico_ram_start + 64 * KiB);
-        m_blocks[power_of_two(32 * KiB)] = reinterpret_cast<Block*>(__pico_ram_start + 32 * KiB);
-        m_blocks[power_of_two(16 * KiB)] = reinterpret_cast<Block*>(__pico_ram_start + 16 * KiB);
-        m_blocks[power_of_two(8 * KiB)] = reinterpret_cast<Block*>(__pico_ram_start + 8 * KiB);
-
-        for (auto& block : m_blocks.span().iter()) {
-            if (block == nullptr)
-                continue;
+        VERIFY(__pico_ram_start + 8 * KiB >= __pico_boot_ram_end);
+        VERIFY(__pico_ram_start + (1 << max_power) <= __pico_ram_end);
 
-            VERIFY(bit_cast<uptr>(block) >= bit_cast<uptr>(__pico_boot_ram_end));
-            VERIFY(bit_cast<uptr>(block) < bit_cast<uptr>(__pico_ram_end));
-
-            // FIXME: We appear to assert when we dereference this pointer.
-            block->m_next = nullptr;
-        }
+        for (usize size = 8 * KiB; size < (1 << max_power); size *= 2)
+            m_buddies.add_range(reinterpret_cast<uptr>(__pico_ram_start + size), power_of_two(size));
     }
 
     Optional<OwnedPageRange> PageAllocator::allocate(usize power)
@@ -65,34 +53,19 @@ namespace Kernel
 
     Optional<PageRange> PageAllocator::allocate_locked(usize power)
     {
-        usize size = 1 << power;
-
         if (debug_page_allocator)
             dbgln("[PageAllocator::allocate] power={}", power);
 
         ASSERT(power <= max_power);
 
-        if (m_blocks[power] != nullptr) {
-            uptr base = reinterpret_cast<uptr>(m_blocks[power]);
-
-            if (debug_page_allocator)
-                dbgln("[PageAllocator::allocate] Found suitable block {}", base);
-
-            m_blocks[power] = m_blocks[power]->m_next;
-            return PageRange { power, base };
-        }
-
-        ASSERT(power < max_power);
-
-        auto block_opt = allocate_locked(power + 1);
-        if (!block_opt.is_valid()) {
+        auto base_opt = m_buddies.allocate(power);
+        if (!base_opt.is_valid())
             return {};
-        }
-        auto block = block_opt.value();
 
-        deallocate_locked(PageRange{ power, block.m_base + size });
+        if (debug_page_allocator)
+            dbgln("[PageAllocator::allocate] Found suitable block {}", base_opt.value());
 
-        return PageRange { power, block.m_base };
+        return PageRange { power, base_opt.value() };
     }
 
     void PageAllocator::deallocate(OwnedPageRange& owned_range)
@@ -114,8 +87,6 @@ namespace Kernel
 
         ASSERT(range.m_power <= max_power);
 
-        auto *block_ptr = reinterpret_cast<Block*>(range.m_base);
-        block_ptr->m_next = m_blocks[range.m_power];
-        m_blocks[range.m_power] = block_ptr;
+        m_buddies.deallocate(range.m_base, range.m_power);
     }
 }
@@ -1,9 +1,9 @@
 #pragma once
 
 #include <Std/Singleton.hpp>
-#include <Std/Array.hpp>
 #include <Std/Optional.hpp>
 #include <Std/Format.hpp>
+#include <Std/BuddyAllocator.hpp>
 
 #include <Kernel/Forward.hpp>
 
@@ -14,6 +14,9 @@ namespace Kernel
     volatile inline bool debug_page_allocator = false;
 
     struct PageRange {
+        // No range is this large, 'Optional<PageRange>' uses it for the empty state.
+        static constexpr usize invalid_power = 0xff;
+
         usize m_power;
         uptr m_base;
 
@@ -25,7 +28,24 @@ namespace Kernel
         ReadonlyBytes bytes() const { return { data(), size() }; }
         Bytes bytes() { return { data(), size() }; }
     };
+}
+
+template<>
+struct Std::OptionalNiche<Kernel::PageRange> {
+    static constexpr bool is_defined = true;
+
+    static void set_empty(u8 *storage)
+    {
+        new (storage) Kernel::PageRange { Kernel::PageRange::invalid_power, 0 };
+    }
+    static bool is_empty(const u8 *storage)
+    {
+        return reinterpret_cast<const Kernel::PageRange*>(storage)->m_power == Kernel::PageRange::invalid_power;
+    }
+};
 
+namespace Kernel
+{
     class OwnedPageRange {
     public:
         explicit OwnedPageRange(PageRange range)
@@ -60,7 +80,9 @@ namespace Kernel
 
     class PageAllocator : public Singleton<PageAllocator> {
     public:
-        static constexpr usize max_power = 19;
+        // The smallest region that the memory protection unit can describe is 256 bytes.
+        static constexpr usize min_power = power_of_two(256);
+        static constexpr usize max_power = power_of_two(256 * KiB);
         static constexpr usize stack_power = power_of_two(0x800);
 
         Optional<OwnedPageRange> allocate(usize power);
@@ -69,12 +91,20 @@ namespace Kernel
         // FIXME: Syncronize
         void dump()
         {
-            dbgln("[PageAllocator] blocks:");
-            for (usize power = 0; power < max_power; ++power) {
-                dbgln("  [{}]: {}", power, m_blocks[power]);
-            }
+            // Every block that is listed here is owned by some 'OwnedPageRange', except the first one which is
+            // used during boot.  Anything that remains after a process exited has been leaked.
+            dbgln("[PageAllocator] allocated blocks:");
+            m_buddies.for_each_allocated_block([](uptr base, usize power) {
+                dbgln("  {} ({} bytes)", base, 1 << power);
+            });
+
+            dbgln("[PageAllocator] occupancy:");
+            m_buddies.dump();
         }
 
+        usize free_bytes() const { return m_buddies.free_bytes(); }
+        Optional<usize> largest_free_power() const { return m_buddies.largest_free_power(); }
+
         void set_mutex_enabled(bool enabled);
 
     private:
@@ -84,15 +114,7 @@ namespace Kernel
         Optional<PageRange> allocate_locked(usize power);
         void deallocate_locked(PageRange);
 
-        // There is quite a bit of trickery going on here:
-        //
-        //   - The address of this block is encoded indirectly in the address of this object
-        //
-        //   - The size of this block is encoded indirection in the index used to access m_blocks
-        struct Block {
-            Block *m_next;
-        };
-
-        Array<Block*, max_power + 1> m_blocks;
+        // Buddies are merged when they are deallocated, thus the RAM doesn't fragment over time.
+        BuddyAllocator<min_power, max_power> m_buddies;
     };
 }
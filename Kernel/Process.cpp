@@ -1,4 +1,5 @@
 #include <Std/OwnPtr.hpp>
+#include <Std/Format.hpp>
 
 #include <Kernel/Process.hpp>
 #include <Kernel/Threads/Scheduler.hpp>
@@ -6,6 +7,7 @@
 #include <Kernel/Interface/System.hpp>
 #include <Kernel/FileSystem/FlashFileSystem.hpp>
 #include <Kernel/FileSystem/MemoryFileSystem.hpp>
+#include <Kernel/Synchronization/MaskedInterruptGuard.hpp>
 
 namespace Kernel
 {
@@ -34,7 +34,8 @@ namespace Kernel
             return *m_handles.get_opt(fd).must();
         }
 
-        Path m_working_directory = "/";
+        // This is always absolute and normalized.
+        ImmutableString m_working_directory = "/";
         ImmutableString m_name;
         Optional<LoadedExecutable> m_executable;
 
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <Std/Forward.hpp>
+
+#include <Kernel/HandlerMode.hpp>
+
 namespace Kernel
 {
     class MaskedInterruptGuard {
@@ -1,4 +1,5 @@
 #include <Std/Forward.hpp>
+#include <Std/Format.hpp>
 
 #include <Kernel/Interface/System.hpp>
 #include <Kernel/ConsoleDevice.hpp>
@@ -9,6 +10,7 @@
 #include <Kernel/GlobalMemoryAllocator.hpp>
 #include <Kernel/Threads/Scheduler.hpp>
 #include <Kernel/Threads/Thread.hpp>
+#include <Kernel/Synchronization/MaskedInterruptGuard.hpp>
 
 namespace Kernel
 {
@@ -17,7 +19,16 @@ namespace Kernel
         thread->set_masked_from_scheduler(true);
 
         VERIFY(is_executing_in_handler_mode());
-        m_waiting_threads.enqueue(move(thread));
+
+        // Once a thread overflowed, the following threads have to queue behind it.
+        if (!m_overflow_threads.is_empty() || !m_waiting_threads.try_push(thread.ptr())) {
+            if (debug_system_handler)
+                dbgln("[SystemHandler] Too many waiting threads, queueing '{}' in overflow list", thread->m_name);
+
+            m_overflow_threads.enqueue(move(thread));
+        } else {
+            thread.leak_ref();
+        }
 
         // Notify the SystemHandler thread that is will spawn the system call worker.
         m_thread->wakeup();
@@ -26,14 +37,34 @@ namespace Kernel
     void SystemHandler::handle_next_waiting_thread()
     {
         RefPtr<Thread> thread;
-        {
+
+        // The ring buffer is popped without masking interrupts, the 'syscall' handler only uses the overflow list while
+        // it is not empty, thus everything in the ring buffer was submitted first.
+        if (auto waiting_thread = m_waiting_threads.try_pop(); waiting_thread.is_valid()) {
+            thread = RefPtr<Thread>::adopt_ref(*waiting_thread.must());
+        } else {
             MaskedInterruptGuard interrupt_guard;
-            thread = m_waiting_threads.dequeue();
+
+            // The overflow list could have been drained while we checked the ring buffer.
+            if (auto waiting_thread = m_waiting_threads.try_pop(); waiting_thread.is_valid())
+                thread = RefPtr<Thread>::adopt_ref(*waiting_thread.must());
+            else
+                thread = m_overflow_threads.dequeue();
         }
 
         if (debug_system_handler)
             dbgln("[SystemHandler] Dealing with system call for '{}'", thread->m_name);
 
+        if (try_assign_worker(thread)) {
+            ++m_worker_pool_hits;
+            return;
+        }
+
+        ++m_worker_pool_misses;
+
+        if (debug_system_handler)
+            dbgln("[SystemHandler] All workers are busy, creating temporary worker (hits={} misses={})", m_worker_pool_hits, m_worker_pool_misses);
+
         // We can not consume the register context here, since it is needed to continue execution.
         FullRegisterContext& context = *thread->m_stashed_context.must();
 
@@ -45,34 +76,98 @@ namespace Kernel
         auto new_worker_thread = Thread::construct(new_worker_thread_name);
         new_worker_thread->m_privileged = true;
 
-        new_worker_thread->setup_context([thread = move(thread), &context] () mutable {
-            i32 return_value = thread->syscall(context.r0.syscall(), context.r1, context.r2, context.r3);
+        new_worker_thread->setup_context([this, thread = move(thread)] () mutable {
+            execute_system_call(move(thread));
+        });
 
-            bool b_should_return = (context.r0.syscall() != _SC_exit);
+        {
+            MaskedInterruptGuard scheduler_guard;
+            Scheduler::the().add_thread(move(new_worker_thread));
+        }
+    }
+
+    bool SystemHandler::try_assign_worker(RefPtr<Thread>& thread)
+    {
+        for (usize index = 0; index < system_handler_worker_count; ++index) {
+            Worker& worker = m_workers[index];
 
-            // System calls return values by magically tweaking the value of the 'r0' register when returning.
-            context.r0.m_storage = bit_cast<u32>(return_value);
+            MaskedInterruptGuard interrupt_guard;
 
-            if (b_should_return) {
-                thread->set_masked_from_scheduler(false);
+            if (worker.m_busy)
+                continue;
 
-                {
-                    MaskedInterruptGuard scheduler_guard;
-                    Scheduler::the().add_thread(move(thread));
-                }
-            } else {
-                VERIFY(thread->m_masked_from_scheduler);
+            worker.m_busy = true;
+            worker.m_client = move(thread);
+
+            // If the worker is still finishing the previous system call, it will pick this up without being woken.
+            worker.m_thread->wakeup();
+
+            return true;
+        }
+
+        return false;
+    }
+
+    void SystemHandler::worker_loop(Worker& worker)
+    {
+        while (true) {
+            bool were_interrupts_enabled = disable_interrupts();
+            VERIFY(were_interrupts_enabled);
+
+            // To avoid a lost wakeup problem, we need to make this check with interrupts disabled.
+            if (!worker.m_busy) {
+                Scheduler::the().get_active_thread().set_masked_from_scheduler(true);
+                Scheduler::the().trigger();
+
+                restore_interrupts(were_interrupts_enabled);
+                continue;
             }
-        });
 
-        {
-            MaskedInterruptGuard scheduler_guard;
-            Scheduler::the().add_thread(move(new_worker_thread));
+            RefPtr<Thread> thread = move(worker.m_client);
+            restore_interrupts(were_interrupts_enabled);
+
+            execute_system_call(move(thread));
+
+            worker.m_busy = false;
+        }
+    }
+
+    void SystemHandler::execute_system_call(RefPtr<Thread> thread)
+    {
+        FullRegisterContext& context = *thread->m_stashed_context.must();
+
+        i32 return_value = thread->syscall(context.r0.syscall(), context.r1, context.r2, context.r3);
+
+        bool b_should_return = (context.r0.syscall() != _SC_exit);
+
+        // System calls return values by magically tweaking the value of the 'r0' register when returning.
+        context.r0.m_storage = bit_cast<u32>(return_value);
+
+        if (b_should_return) {
+            thread->set_masked_from_scheduler(false);
+
+            {
+                MaskedInterruptGuard scheduler_guard;
+                Scheduler::the().add_thread(move(thread));
+            }
+        } else {
+            VERIFY(thread->m_masked_from_scheduler);
         }
     }
 
     SystemHandler::SystemHandler()
     {
+        for (usize index = 0; index < system_handler_worker_count; ++index) {
+            Worker& worker = m_workers[index];
+
+            worker.m_thread = Thread::construct(ImmutableString::format("Kernel: SystemHandler Worker {}", index));
+            worker.m_thread->m_privileged = true;
+            worker.m_thread->set_masked_from_scheduler(true);
+            worker.m_thread->setup_context([this, &worker] {
+                worker_loop(worker);
+            });
+        }
+
         m_thread = Thread::construct("Kernel: SystemHandler");
         m_thread->m_privileged = true;
         m_thread->set_masked_from_scheduler(true);
@@ -84,7 +179,7 @@ namespace Kernel
                 // To avoid a lost wakeup problem, we need to make this check with interrupts disabled.
                 // When adding multi-core support, we will also need a mutex here.
                 VERIFY(not are_interrupts_enabled());
-                if (m_waiting_threads.size() == 0) {
+                if (m_waiting_threads.is_empty() && m_overflow_threads.is_empty()) {
                     // If another thread tries to make a system call, it will call 'Thread::wakeup()' which will schedule us again.
                     Scheduler::the().get_active_thread().set_masked_from_scheduler(true);
 
@@ -2,30 +2,67 @@
 
 #include <Std/Forward.hpp>
 #include <Std/Singleton.hpp>
-#include <Std/CircularQueue.hpp>
+#include <Std/RingBuffer.hpp>
+#include <Std/Array.hpp>
+#include <Std/IntrusiveList.hpp>
 
 #include <Kernel/Forward.hpp>
 #include <Kernel/Result.hpp>
+#include <Kernel/Threads/Thread.hpp>
 
 namespace Kernel
 {
     constexpr bool debug_system_handler = false;
 
+    // Number of worker threads that are created when the system boots.
+    // If all of them are busy, a temporary worker thread is created for the system call.
+    constexpr usize system_handler_worker_count = 2;
+
+    // Every thread has at most one system call in flight, if more threads are waiting, they overflow into a list.
+    constexpr usize system_handler_submission_count = 64;
+
     class SystemHandler : public Singleton<SystemHandler> {
     public:
         void notify_worker_thread(RefPtr<Thread> thread);
 
+        usize worker_pool_hits() const { return m_worker_pool_hits; }
+        usize worker_pool_misses() const { return m_worker_pool_misses; }
+
     private:
+        struct Worker {
+            RefPtr<Thread> m_thread;
+
+            // The thread that made the system call, this is consumed by the worker.
+            RefPtr<Thread> m_client;
+
+            volatile bool m_busy = false;
+        };
+
         RefPtr<Thread> m_thread;
 
-        // In thread mode, we must disable interrupts to interact with this.
-        // For multi-core support, we would need some sort of mutex here.
-        CircularQueue<RefPtr<Thread>, 16> m_waiting_threads;
+        // The 'syscall' handler is the only producer and the SystemHandler thread is the only consumer.
+        // Each thread holds a reference that was leaked with 'RefPtr::leak_ref'.
+        // For multi-core support, we would need one of these for each core.
+        RingBuffer<Thread*, system_handler_submission_count> m_waiting_threads;
+
+        // Threads that did not fit into 'm_waiting_threads', they are handled after all the threads in the ring buffer.
+        // The consumer has to disable interrupts to access this.
+        IntrusiveRefList<Thread, &Thread::m_queue_node> m_overflow_threads;
+
+        // Idle workers are masked from the scheduler until they are assigned a system call.
+        Array<Worker, system_handler_worker_count> m_workers;
+
+        usize m_worker_pool_hits = 0;
+        usize m_worker_pool_misses = 0;
 
         friend Singleton<SystemHandler>;
         SystemHandler();
 
         void handle_next_waiting_thread();
+        bool try_assign_worker(RefPtr<Thread>& thread);
+
+        void worker_loop(Worker& worker);
+        void execute_system_call(RefPtr<Thread> thread);
     };
 
     // FIXME: Most of this stuff should go to different places
@@ -87,7 +124,7 @@ namespace Kernel
 
 template<>
 struct Std::Formatter<Kernel::ExceptionRegisterContext> {
-    static void format(StringBuilder& builder, const Kernel::ExceptionRegisterContext& context)
+    static void format(FormatSink& builder, const Kernel::ExceptionRegisterContext& context)
     {
         builder.appendf("r0={} r1={} r2={}   r3={}\n", context.r0.m_storage, context.r1.m_storage, context.r2.m_storage, context.r3.m_storage);
         builder.appendf("ip={} lr={} pc={} xpsr={}\n", context.ip.m_storage, context.lr.m_storage, context.pc.m_storage, context.xpsr.m_storage);
@@ -96,7 +133,7 @@ struct Std::Formatter<Kernel::ExceptionRegisterContext> {
 
 template<>
 struct Std::Formatter<Kernel::FullRegisterContext> {
-    static void format(StringBuilder& builder, const Kernel::FullRegisterContext& context)
+    static void format(FormatSink& builder, const Kernel::FullRegisterContext& context)
     {
         builder.appendf("r0={} r1={}  r2={}   r3={}\n", context.r1.m_storage, context.r2.m_storage, context.r3.m_storage, context.r4.m_storage);
         builder.appendf("ip={} lr={}  pc={} xpsr={}\n", context.ip.m_storage, context.lr.m_storage, context.pc.m_storage, context.xpsr.m_storage);
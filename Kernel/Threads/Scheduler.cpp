@@ -1,8 +1,11 @@
+#include <Std/Format.hpp>
+
 #include <Kernel/Threads/Scheduler.hpp>
 #include <Kernel/Loader.hpp>
 #include <Kernel/HandlerMode.hpp>
 #include <Kernel/GlobalMemoryAllocator.hpp>
 #include <Kernel/KernelMutex.hpp>
+#include <Kernel/Synchronization/MaskedInterruptGuard.hpp>
 
 #include <hardware/structs/scb.h>
 #include <hardware/structs/systick.h>
@@ -134,7 +137,7 @@ namespace Kernel
                 RefPtr<Thread> thread = m_dangling_threads.dequeue();
 
                 // At this point, we no longer need to synchronize, the cleanup can happen in parallel.
-                interrupt_guard.release();
+                interrupt_guard.release_early();
 
                 // I do not know, if this can happen, better check for it.
                 VERIFY(!dbgln_mutex.is_locked());
@@ -202,14 +205,12 @@ namespace Kernel
         VERIFY(is_executing_in_handler_mode() || !are_interrupts_enabled());
 
         dbgln("[Scheduler] m_queued_threads:");
-        for (size_t i = 0; i < m_queued_threads.size(); ++i) {
-            Thread& thread = *m_queued_threads[i];
+        for (Thread& thread : m_queued_threads.iter()) {
             dbgln("  {} @{}", thread.m_name, &thread);
         }
 
         dbgln("[Scheduler] m_danging_threads:");
-        for (size_t i = 0; i < m_dangling_threads.size(); ++i) {
-            Thread& thread = *m_dangling_threads[i];
+        for (Thread& thread : m_dangling_threads.iter()) {
             dbgln("  {} @{}", thread.m_name, &thread);
         }
 
@@ -2,7 +2,7 @@
 
 #include <Std/Singleton.hpp>
 #include <Std/Vector.hpp>
-#include <Std/CircularQueue.hpp>
+#include <Std/IntrusiveList.hpp>
 
 #include <Kernel/Forward.hpp>
 #include <Kernel/Threads/Thread.hpp>
@@ -42,7 +42,7 @@ namespace Kernel
         void add_thread(RefPtr<Thread> thread)
         {
             VERIFY(is_executing_in_handler_mode() || !are_interrupts_enabled());
-            m_queued_threads.enqueue(thread);
+            m_queued_threads.enqueue(move(thread));
         }
 
         void dump();
@@ -54,8 +54,8 @@ namespace Kernel
 
         // In thread mode, we must disable interrupts to interact with these.
         // For multi-thread support, we should add a mutex here.
-        CircularQueue<RefPtr<Thread>, 16> m_queued_threads;
-        CircularQueue<RefPtr<Thread>, 16> m_dangling_threads;
+        IntrusiveRefList<Thread, &Thread::m_queue_node> m_queued_threads;
+        IntrusiveRefList<Thread, &Thread::m_queue_node> m_dangling_threads;
         RefPtr<Thread> m_active_thread = nullptr;
 
     private:
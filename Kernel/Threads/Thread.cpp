@@ -1,3 +1,5 @@
+#include <Std/Format.hpp>
+
 #include <Kernel/Threads/Thread.hpp>
 #include <Kernel/Threads/Scheduler.hpp>
 #include <Kernel/Interface/System.hpp>
@@ -10,6 +12,23 @@ namespace Kernel
 {
     constexpr bool debug_syscall = false;
 
+    // Returns the absolute and normalized path, this is only needed if the path is stored.
+    static ImmutableString resolve_path(PathView working_directory, PathView path)
+    {
+        StringBuilder builder;
+
+        PathView::for_each_resolved_component(working_directory, path, [&](StringView component) {
+            builder.append('/');
+            builder.append(component);
+            return IterationDecision::Continue;
+        });
+
+        if (builder.size() == 0)
+            builder.append('/');
+
+        return builder.string();
+    }
+
     Thread::Thread(ImmutableString name)
         : m_name(move(name))
     {
@@ -31,7 +50,7 @@ namespace Kernel
     void Thread::die()
     {
         if (debug_thread)
-            dbgln("[Thread::setup_context::lambda] Thread '{}' is about to die.", this->m_name, this);
+            dbgln("[Thread::setup_context::lambda] Thread '{}' is about to die.", this->m_name);
 
         // This will prevent us from being scheduled again.
         // The destructor will run when the last reference is dropped.
@@ -81,6 +100,11 @@ namespace Kernel
     {
         VERIFY(Scheduler::the().get_active_thread_if_avaliable() != this);
 
+        // A thread that is waiting for a 'KernelMutex' is still linked into the mutex, 'KernelMutex::unlock' wakes it up
+        // again once it owns the mutex.  Whoever tried to wake it up now must check their condition after the lock.
+        if (m_queue_node.is_linked())
+            return;
+
         if (m_masked_from_scheduler) {
             m_masked_from_scheduler = false;
             Scheduler::the().add_thread(*this);
@@ -160,16 +184,14 @@ namespace Kernel
         if (debug_syscall)
             dbgln("Thread::sys$open");
 
-        Path path = pathname;
-
-        if (!path.is_absolute())
-            path = m_process->m_working_directory / path;
+        PathView path { pathname };
+        PathView working_directory { m_process->m_working_directory };
 
-        auto file_opt = Kernel::FileSystem::try_lookup(path);
+        auto file_opt = Kernel::FileSystem::try_lookup(path, working_directory);
 
         if (file_opt.is_error()) {
             if (file_opt.error() == ENOENT && (flags & O_CREAT)) {
-                auto parent_opt = Kernel::FileSystem::try_lookup(path.parent());
+                auto parent_opt = Kernel::FileSystem::try_lookup(path.parent(), working_directory);
 
                 if (parent_opt.is_error()) {
                     dbgln("[Process::sys$open] error={}", ENOTDIR);
@@ -249,7 +271,7 @@ namespace Kernel
         if (debug_syscall)
             dbgln("Thread::sys$get_working_directory");
 
-        auto string = m_process->m_working_directory.string();
+        auto& string = m_process->m_working_directory;
 
         if (string.size() + 1 > *buffer_size) {
             *buffer_size = string.size() + 1;
@@ -283,18 +305,16 @@ namespace Kernel
         while (*envp != nullptr)
             arguments.append(*envp++);
 
-        Path path { pathname };
-
-        if (!path.is_absolute())
-            path = m_process->m_working_directory / path;
+        // The path is also used to find the executable on the host, thus it has to be normalized.
+        auto path = resolve_path(PathView { m_process->m_working_directory }, pathname);
 
         HashMap<ImmutableString, ImmutableString> system_to_host;
         system_to_host.set("/bin/Shell.elf", "Userland/Shell.1.elf");
         system_to_host.set("/bin/Example.elf", "Userland/Example.1.elf");
         system_to_host.set("/bin/Editor.elf", "Userland/Editor.1.elf");
 
-        auto& file = dynamic_cast<FlashFile&>(FileSystem::lookup(path));
-        ElfWrapper elf { file.m_data.data(), system_to_host.get_opt(path.string()).must() };
+        auto& file = dynamic_cast<FlashFile&>(*FileSystem::try_lookup(PathView { path }).must());
+        ElfWrapper elf { file.m_data.data(), system_to_host.get_opt(path).must() };
 
         auto& new_process = Kernel::Process::create(pathname, move(elf), arguments, environment);
         new_process.m_parent = m_process;
@@ -343,12 +363,10 @@ namespace Kernel
         if (debug_syscall)
             dbgln("Thread::sys$chdir");
 
-        Path path { pathname };
-
-        if (!path.is_absolute())
-            path = m_process->m_working_directory / path;
+        PathView path { pathname };
+        PathView working_directory { m_process->m_working_directory };
 
-        auto file_opt = Kernel::FileSystem::try_lookup(path);
+        auto file_opt = Kernel::FileSystem::try_lookup(path, working_directory);
 
         if (file_opt.is_error())
             return -file_opt.error();
@@ -356,7 +374,7 @@ namespace Kernel
         if ((file_opt.value()->m_mode & ModeFlags::Format) != ModeFlags::Directory)
             return -ENOTDIR;
 
-        m_process->m_working_directory = path;
+        m_process->m_working_directory = resolve_path(working_directory, path);
 
         return 0;
     }
@@ -3,10 +3,11 @@
 #include <Std/String.hpp>
 #include <Std/Optional.hpp>
 #include <Std/RefPtr.hpp>
+#include <Std/ObjectPool.hpp>
+#include <Std/IntrusiveList.hpp>
 
 #include <Kernel/Forward.hpp>
 #include <Kernel/PageAllocator.hpp>
-#include <Kernel/SystemHandler.hpp>
 #include <Kernel/MPU.hpp>
 #include <Kernel/StackWrapper.hpp>
 #include <Kernel/Interface/Types.hpp>
@@ -16,7 +17,7 @@ namespace Kernel
 {
     constexpr bool debug_thread = false;
 
-    class Thread : public RefCounted<Thread> {
+    class Thread : public RefCounted<Thread>, public PoolAllocated<Thread> {
     public:
         ImmutableString m_name;
         volatile bool m_privileged = false;
@@ -31,6 +32,10 @@ namespace Kernel
 
         volatile bool m_is_default_thread = false;
 
+        // A thread is waiting in at most one queue at a time: it is either queued in the scheduler, dangling, waiting
+        // for a 'KernelMutex' or waiting for the 'SystemHandler' to pick up its system call.
+        IntrusiveListNode<Thread> m_queue_node;
+
         Optional<FullRegisterContext*> m_stashed_context;
         RefPtr<Process> m_process;
 
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <Std/Forward.hpp>
+#include <Std/Array.hpp>
+#include <Std/Optional.hpp>
+#include <Std/Format.hpp>
+
+namespace Std
+{
+    // Manages a region of '2^RegionPower' bytes that is split into blocks with power of two sizes.
+    //
+    // Every possible block is a node in an implicit binary tree: the whole region is node one and the children
+    // of node 'n' are '2n' and '2n+1'.  Thus, the buddy of a block is found by flipping the lowest bit of the
+    // node index.
+    //
+    // For every node, we store four bits that describe the state of the block:
+    //
+    //   - If the block is allocated, we store 'allocated_value'.
+    //
+    //   - If the block is free, we store the encoded size of the block itself.
+    //
+    //   - If the block is split, we store the encoded size of the largest free block in this subtree or zero if
+    //     there is nothing free.  Since that block is smaller, this can not be confused with a free block.
+    //
+    // Nodes below a free or allocated block are meaningless.  This makes it possible to find a suitable block
+    // in logarithmic time and the largest free block can be read directly from the root.  Free memory is never
+    // touched by the allocator.
+    template<usize MinimumPower, usize RegionPower>
+    class BuddyAllocator {
+    public:
+        static constexpr usize minimum_power = MinimumPower;
+        static constexpr usize region_power = RegionPower;
+
+        static_assert(MinimumPower <= RegionPower);
+
+        // Initially, all the memory is considered to be in use.  Use 'add_range' to make it avaliable.
+        explicit BuddyAllocator(uptr base)
+            : m_base(base)
+        {
+            for (auto& byte : m_tree.span().iter())
+                byte = 0;
+
+            set_value(1, allocated_value);
+        }
+
+        BuddyAllocator(const BuddyAllocator&) = delete;
+        BuddyAllocator(BuddyAllocator&&) = delete;
+
+        uptr base() const { return m_base; }
+
+        Optional<uptr> allocate(usize power)
+        {
+            VERIFY(power >= MinimumPower);
+            VERIFY(power <= RegionPower);
+
+            if (largest_value(1) < encode(power))
+                return {};
+
+            usize node = 1;
+            for (usize node_power = RegionPower; node_power > power; --node_power) {
+                if (value(node) == encode(node_power)) {
+                    set_value(left(node), encode(node_power - 1));
+                    set_value(right(node), encode(node_power - 1));
+                }
+
+                // Prefer the subtree with the smaller free block that fits, this keeps large blocks intact.
+                u8 left_value = largest_value(left(node));
+                u8 right_value = largest_value(right(node));
+
+                if (left_value >= encode(power) && (right_value < encode(power) || left_value <= right_value))
+                    node = left(node);
+                else
+                    node = right(node);
+            }
+
+            VERIFY(value(node) == encode(power));
+            set_value(node, allocated_value);
+            update_ancestors(node);
+
+            m_free_bytes -= 1 << power;
+
+            return m_base + offset_of(node, power);
+        }
+
+        void deallocate(uptr address, usize power)
+        {
+            usize node = node_of(address, power);
+
+            // This catches double frees and blocks that were never allocated with this size.
+            for (usize ancestor = node >> 1; ancestor >= 1; ancestor >>= 1)
+                VERIFY(is_split(ancestor));
+
+            VERIFY(value(node) == allocated_value);
+            set_value(node, encode(power));
+            update_ancestors(node);
+
+            m_free_bytes += 1 << power;
+        }
+
+        // Makes memory avaliable that was in use from the beginning.
+        void add_range(uptr address, usize power)
+        {
+            usize node = node_of(address, power);
+
+            // Split the allocated block that contains this range.
+            for (usize shift = RegionPower - power; shift > 0; --shift) {
+                usize ancestor = node >> shift;
+
+                if (value(ancestor) == allocated_value) {
+                    set_value(left(ancestor), allocated_value);
+                    set_value(right(ancestor), allocated_value);
+                    set_value(ancestor, 0);
+                }
+
+                VERIFY(value(ancestor) != encode(power_of(ancestor)));
+            }
+
+            deallocate(address, power);
+        }
+
+        bool is_free(uptr address, usize power) const
+        {
+            usize node = node_of(address, power);
+
+            for (usize ancestor = node >> 1; ancestor >= 1; ancestor >>= 1) {
+                if (!is_split(ancestor))
+                    return false;
+            }
+
+            return value(node) == encode(power);
+        }
+
+        // Returns the size of the largest block that can currently be allocated.
+        Optional<usize> largest_free_power() const
+        {
+            if (largest_value(1) == 0)
+                return {};
+
+            return largest_value(1) - 1 + MinimumPower;
+        }
+
+        usize free_bytes() const { return m_free_bytes; }
+
+        template<typename Callback>
+        void for_each_allocated_block(Callback&& callback) const
+        {
+            for_each_allocated_block_impl(1, callback);
+        }
+
+        // Prints one character for every block of the minimum size, '#' is in use and '.' is avaliable.
+        void dump() const
+        {
+            constexpr usize blocks_per_row = 64;
+            constexpr usize block_count = 1 << (RegionPower - MinimumPower);
+
+            auto largest_power = largest_free_power();
+            if (largest_power.is_valid())
+                dbgln("  largest free block: {} bytes", 1 << largest_power.value());
+            else
+                dbgln("  largest free block: none");
+
+            dbgln("  free: {} bytes", m_free_bytes);
+
+            for (usize row = 0; row < block_count; row += blocks_per_row) {
+                char buffer[blocks_per_row];
+
+                usize count = min(blocks_per_row, block_count - row);
+                for (usize index = 0; index < count; ++index)
+                    buffer[index] = is_free_leaf(row + index) ? '.' : '#';
+
+                dbgln("  {}: {}", m_base + (row << MinimumPower), StringView { buffer, count });
+            }
+        }
+
+    private:
+        static constexpr usize level_count = RegionPower - MinimumPower + 1;
+        static constexpr usize node_count = 1 << level_count;
+
+        static constexpr u8 allocated_value = 0xf;
+        static_assert(level_count < allocated_value);
+
+        uptr m_base;
+        usize m_free_bytes = 0;
+
+        // Two nodes are packed into each byte.
+        Array<u8, node_count / 2> m_tree;
+
+        static u8 encode(usize power) { return power - MinimumPower + 1; }
+
+        static usize left(usize node) { return 2 * node; }
+        static usize right(usize node) { return 2 * node + 1; }
+
+        static usize power_of(usize node)
+        {
+            return RegionPower - (31 - __builtin_clz(node));
+        }
+        static uptr offset_of(usize node, usize power)
+        {
+            return (node - (1 << (RegionPower - power))) << power;
+        }
+
+        usize node_of(uptr address, usize power) const
+        {
+            VERIFY(power >= MinimumPower);
+            VERIFY(power <= RegionPower);
+
+            VERIFY(address >= m_base);
+            uptr offset = address - m_base;
+
+            VERIFY(offset < (1 << RegionPower));
+            VERIFY(offset % (1 << power) == 0);
+
+            return (1 << (RegionPower - power)) + (offset >> power);
+        }
+
+        u8 value(usize node) const
+        {
+            return (m_tree[node / 2] >> (node % 2 * 4)) & 0xf;
+        }
+        void set_value(usize node, u8 value)
+        {
+            m_tree[node / 2] = (m_tree[node / 2] & ~(0xf << (node % 2 * 4))) | (value << (node % 2 * 4));
+        }
+
+        // The encoded size of the largest free block in this subtree.
+        u8 largest_value(usize node) const
+        {
+            u8 node_value = value(node);
+            return node_value == allocated_value ? 0 : node_value;
+        }
+
+        bool is_split(usize node) const
+        {
+            return value(node) != allocated_value && value(node) != encode(power_of(node));
+        }
+
+        void update_ancestors(usize node)
+        {
+            for (usize power = power_of(node); node > 1; ++power) {
+                usize buddy = node ^ 1;
+                node >>= 1;
+
+                // If both buddies are free, they are merged.
+                if (value(buddy) == encode(power) && value(buddy ^ 1) == encode(power))
+                    set_value(node, encode(power + 1));
+                else
+                    set_value(node, max(largest_value(left(node)), largest_value(right(node))));
+            }
+        }
+
+        bool is_free_leaf(usize index) const
+        {
+            usize leaf = (1 << (RegionPower - MinimumPower)) + index;
+
+            for (usize shift = RegionPower - MinimumPower + 1; shift > 0; --shift) {
+                usize node = leaf >> (shift - 1);
+
+                if (value(node) == allocated_value)
+                    return false;
+                if (value(node) == encode(power_of(node)))
+                    return true;
+            }
+
+            VERIFY_NOT_REACHED();
+        }
+
+        template<typename Callback>
+        void for_each_allocated_block_impl(usize node, Callback& callback) const
+        {
+            if (value(node) == allocated_value) {
+                callback(m_base + offset_of(node, power_of(node)), power_of(node));
+                return;
+            }
+
+            if (is_split(node)) {
+                for_each_allocated_block_impl(left(node), callback);
+                for_each_allocated_block_impl(right(node), callback);
+            }
+        }
+    };
+}
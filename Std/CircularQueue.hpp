@@ -37,7 +37,7 @@ namespace Std
                 auto& target = *reinterpret_cast<T*>(m_data + offset * sizeof(T));
 
                 builder.append(prefix);
-                builder.appendf("%", target);
+                builder.appendf("{}", target);
 
                 prefix = ", ";
             }
@@ -21,10 +21,25 @@ namespace Std {
         using Type = T;
     };
 
+    template<bool Condition, typename T, typename F>
+    struct Conditional {
+        using Type = T;
+    };
+    template<typename T, typename F>
+    struct Conditional<false, T, F> {
+        using Type = F;
+    };
+
     template<typename T, T Value>
     struct IntegralConstant {
         static constexpr T value = Value;
     };
+
+    // Objects of these types can be moved to another address with 'memcpy', without calling the move constructor
+    // and the destructor.  Types that do not refer to their own address can opt in by specializing this.
+    template<typename T>
+    struct IsTriviallyRelocatable : IntegralConstant<bool, __is_trivially_copyable(T)> {
+    };
 }
 
 namespace Std::Concepts {
@@ -49,4 +64,10 @@ namespace Std::Concepts {
 
     template<typename T, usize Size>
     concept HasSizeOf = IntegralConstant<bool, sizeof(T) == Size>::value;
+
+    template<typename T>
+    concept TriviallyCopyable = __is_trivially_copyable(T);
+
+    template<typename T>
+    concept TriviallyRelocatable = IsTriviallyRelocatable<T>::value;
 }
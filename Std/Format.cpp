@@ -15,73 +15,242 @@
 
 namespace Std
 {
-    void dbgln_raw(StringView str)
+    static void write_console(StringView value)
     {
-        if (Kernel::is_executing_in_handler_mode())
-            return;
+#ifdef KERNEL
+        Kernel::ConsoleFileHandle handle;
+        handle.write(value.bytes());
+#else
+        std::cout << std::string_view { value.data(), value.size() };
+#endif
+    }
 
+    DebugFormatSink::DebugFormatSink()
+    {
 #ifdef KERNEL
+        m_enabled = !Kernel::is_executing_in_handler_mode();
+
         // FIXME: For multi-core support, we will need a mutex here.
         //        We would need to mask interrupts and then get the mutex.
         //        However, that will be quite involved, because of the deadlock risk.
-        {
-            Kernel::MaskedInterruptGuard interrupt_guard;
+        if (m_enabled)
+            m_were_interrupts_enabled = Kernel::disable_interrupts();
+#else
+        m_enabled = true;
+        m_were_interrupts_enabled = false;
+#endif
 
-            StringView prefix = "\e[36m";
-            StringView suffix = "\e[0m\n";
+        if (m_enabled)
+            write_console("\e[36m");
+    }
 
-            Kernel::ConsoleFileHandle handle;
-            handle.write(prefix.bytes());
-            handle.write(str.bytes());
-            handle.write(suffix.bytes());
-        }
-#else
-        std::cout << "\e[36m" << std::string_view { str.data(), str.size() } << "\e[0m\n";
+    DebugFormatSink::~DebugFormatSink()
+    {
+        if (!m_enabled)
+            return;
+
+        flush();
+        write_console("\e[0m\n");
+
+#ifdef KERNEL
+        Kernel::restore_interrupts(m_were_interrupts_enabled);
 #endif
     }
 
+    void DebugFormatSink::write(StringView value)
+    {
+        if (!m_enabled)
+            return;
+
+        // Large pieces are not copied into the buffer.
+        if (value.size() >= sizeof(m_buffer)) {
+            flush();
+            write_console(value);
+            return;
+        }
+
+        if (m_size + value.size() > sizeof(m_buffer))
+            flush();
+
+        __builtin_memcpy(m_buffer + m_size, value.data(), value.size());
+        m_size += value.size();
+    }
+
+    void DebugFormatSink::flush()
+    {
+        if (m_size == 0)
+            return;
+
+        write_console({ m_buffer, m_size });
+        m_size = 0;
+    }
+
+    void dbgln_raw(StringView str)
+    {
+        DebugFormatSink sink;
+        sink.write(str);
+    }
+
+    void format_string_error(const char *message)
+    {
+        VERIFY_NOT_REACHED();
+    }
+
+    static constexpr char decimal_digit_pairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    // These write the digits backwards, ending before 'end', and return the number of digits.
+    template<typename T>
+    static usize write_decimal(char *end, T value)
+    {
+        char *pointer = end;
+
+        while (value >= 100) {
+            usize index = (value % 100) * 2;
+            value /= 100;
+
+            *--pointer = decimal_digit_pairs[index + 1];
+            *--pointer = decimal_digit_pairs[index];
+        }
+
+        if (value >= 10) {
+            usize index = value * 2;
+            *--pointer = decimal_digit_pairs[index + 1];
+            *--pointer = decimal_digit_pairs[index];
+        } else {
+            *--pointer = static_cast<char>('0' + value);
+        }
+
+        return end - pointer;
+    }
+    template<typename T>
+    static usize write_hexadecimal(char *end, T value, usize minimum_digits)
+    {
+        char *pointer = end;
+
+        do {
+            *--pointer = "0123456789abcdef"[value & 0xf];
+            value >>= 4;
+        } while (value != 0);
+
+        while (usize(end - pointer) < minimum_digits)
+            *--pointer = '0';
+
+        return end - pointer;
+    }
+
+    // The magnitude is formatted as 32-bit value if possible, 64-bit division is very slow on the RP2040.
+    template<typename T>
+    static usize write_magnitude(char *end, T value, const FormatSpecifier& specifier, usize minimum_digits, bool& is_negative)
+    {
+        is_negative = value < 0;
+
+        if constexpr (sizeof(T) <= sizeof(u32)) {
+            u32 magnitude = is_negative ? u32(0) - u32(value) : u32(value);
+            if (specifier.m_base == FormatSpecifier::Base::Decimal)
+                return write_decimal(end, magnitude);
+            return write_hexadecimal(end, magnitude, minimum_digits);
+        } else {
+            u64 magnitude = is_negative ? u64(0) - u64(value) : u64(value);
+            if (specifier.m_base == FormatSpecifier::Base::Decimal)
+                return write_decimal(end, magnitude);
+            return write_hexadecimal(end, magnitude, minimum_digits);
+        }
+    }
+
     template<typename T>
     requires Concepts::Integral<T>
-    void Formatter<T>::format(StringBuilder& builder, T value)
+    void Formatter<T>::format(FormatSink& builder, T value)
     {
-        if (value < 0) {
+        char buffer[2 + sizeof(T) * 2];
+        char *end = buffer + sizeof(buffer);
+
+        bool is_negative;
+        usize count = write_magnitude(end, value, FormatSpecifier { FormatSpecifier::Base::Hexadecimal }, sizeof(T) * 2, is_negative);
+
+        *(end - count - 2) = '0';
+        *(end - count - 1) = 'x';
+        count += 2;
+
+        if (is_negative)
             builder.append('-');
-            return format(builder, -value);
+        builder.append(StringView { end - count, count });
+    }
+
+    template<typename T>
+    requires Concepts::Integral<T>
+    void Formatter<T>::format(FormatSink& builder, T value, const FormatSpecifier& specifier)
+    {
+        char buffer[20];
+        char *end = buffer + sizeof(buffer);
+
+        bool is_negative;
+        usize count = write_magnitude(end, value, specifier, 1, is_negative);
+
+        bool has_prefix = specifier.m_prefix && specifier.m_base == FormatSpecifier::Base::Hexadecimal;
+
+        usize size = count + (is_negative ? 1 : 0) + (has_prefix ? 2 : 0);
+        usize padding = specifier.m_width > size ? specifier.m_width - size : 0;
+
+        if (!specifier.m_zero_pad) {
+            for (usize index = 0; index < padding; ++index)
+                builder.append(' ');
         }
 
-        builder.append("0x");
+        if (is_negative)
+            builder.append('-');
+        if (has_prefix)
+            builder.append("0x");
 
-        char buffer[sizeof(T) * 2];
-        for (usize index = 0; index < sizeof(buffer); ++index) {
-            buffer[index] = "0123456789abcdef"[value % 16];
-            value /= 16;
+        if (specifier.m_zero_pad) {
+            for (usize index = 0; index < padding; ++index)
+                builder.append('0');
         }
 
-        for (usize index = 0; index < sizeof(buffer); ++index)
-            builder.append(buffer[(sizeof(buffer) - 1) - index]);
+        builder.append(StringView { end - count, count });
     }
 
-    void Formatter<StringView>::format(StringBuilder& builder, StringView value)
+    void Formatter<StringView>::format(FormatSink& builder, StringView value)
     {
         builder.append(value);
         return;
     }
 
-    void Formatter<bool>::format(StringBuilder& builder, bool value)
+    void Formatter<bool>::format(FormatSink& builder, bool value)
     {
         if (value)
             builder.append("true");
         else
             builder.append("false");
     }
-    void Formatter<char>::format(StringBuilder& builder, char value)
+    void Formatter<char>::format(FormatSink& builder, char value)
     {
         builder.append(value);
     }
 
-    void Formatter<Path>::format(StringBuilder& builder, const Path& value)
+    void Formatter<Path>::format(FormatSink& builder, const Path& value)
     {
-        builder.append(value.string());
+        // This does not use 'Path::string', it would allocate.
+        if (value.is_absolute())
+            builder.append('/');
+
+        bool put_slash = false;
+        for (auto& component : value.components()) {
+            if (put_slash)
+                builder.append('/');
+            put_slash = true;
+
+            builder.append(component);
+        }
     }
 
 
@@ -8,12 +8,56 @@
 #include <Std/String.hpp>
 #include <Std/Lexer.hpp>
 #include <Std/RefPtr.hpp>
+#include <Std/ObjectPool.hpp>
 
 namespace Std
 {
     class StringBuilder;
     class ImmutableString;
 
+    // Formatters write through this, the output can be collected in memory or written to a device directly.
+    class FormatSink {
+    public:
+        virtual ~FormatSink() = default;
+
+        virtual void write(StringView) = 0;
+
+        void append(char value) { write({ &value, 1 }); }
+        void append(StringView value) { write(value); }
+
+        template<typename... Parameters>
+        void appendf(FormatString<typename TypeIdentity<Parameters>::Type...> fmtstr, const Parameters&... parameters)
+        {
+            fmtstr.format(*this, parameters...);
+        }
+    };
+
+    // Writes into a fixed buffer, the output is truncated if it does not fit.
+    class FixedBufferFormatSink final : public FormatSink {
+    public:
+        explicit FixedBufferFormatSink(Span<char> buffer)
+            : m_buffer(buffer)
+        {
+        }
+
+        void write(StringView value) override
+        {
+            usize count = min(value.size(), m_buffer.size() - m_size);
+            __builtin_memcpy(m_buffer.data() + m_size, value.data(), count);
+
+            m_size += count;
+            m_truncated |= count != value.size();
+        }
+
+        StringView view() const { return { m_buffer.data(), m_size }; }
+        bool is_truncated() const { return m_truncated; }
+
+    private:
+        Span<char> m_buffer;
+        usize m_size = 0;
+        bool m_truncated = false;
+    };
+
     extern volatile int dbgln_called_in_interrupt;
 
     template<typename T>
@@ -30,7 +74,7 @@ namespace Std
         static constexpr bool value = false;
     };
 
-    using FormatFunction = void(*)(StringBuilder&, const void*);
+    using FormatFunction = void(*)(FormatSink&, const void*);
 
     struct TypeErasedFormatParameter {
         const void *m_value;
@@ -61,7 +105,7 @@ namespace Std
         explicit VariadicFormatParams(const Parameters&... parameters)
             : m_params { TypeErasedFormatParameter {
                 &parameters,
-                [](StringBuilder& builder, const void *value)
+                [](FormatSink& builder, const void *value)
                 {
                     Formatter<Parameters>::format(builder, *reinterpret_cast<const Parameters*>(value));
                 },
@@ -74,9 +118,192 @@ namespace Std
         Array<TypeErasedFormatParameter, sizeof...(Parameters)> m_params;
     };
 
-    void vformat(StringBuilder&, StringView fmtstr, TypeErasedFormatParams);
+    void vformat(FormatSink&, StringView fmtstr, TypeErasedFormatParams);
 
-    class ImmutableStringInstance : public RefCounted<ImmutableStringInstance> {
+    // Written as '{:[#][0][width][d|x]}', only integers accept a specifier.  Integers without a specifier are printed as
+    // hexadecimal with all digits.
+    struct FormatSpecifier {
+        enum class Base : u8 {
+            Default,
+            Decimal,
+            Hexadecimal,
+        };
+
+        Base m_base = Base::Default;
+
+        // Prefix hexadecimal numbers with '0x', the width includes the prefix.
+        bool m_prefix = false;
+
+        // Pad with zeros instead of spaces, zeros are placed after the sign and the prefix.
+        bool m_zero_pad = false;
+
+        u8 m_width = 0;
+
+        constexpr bool is_default() const { return m_base == Base::Default && !m_prefix && !m_zero_pad && m_width == 0; }
+    };
+
+    // Calling this in a constant expression fails the compilation.
+    void format_string_error(const char *message);
+
+    // A format string that is parsed and checked against the parameters when compiling.  The placeholders and
+    // specifiers are known in advance, thus formatting only copies the literal text and calls the formatters.
+    template<typename... Parameters>
+    class FormatString {
+    public:
+        template<usize Size>
+        consteval FormatString(const char (&fmtstr)[Size])
+            : m_data(fmtstr)
+            , m_size(Size - 1)
+        {
+            parse();
+        }
+
+        StringView view() const { return { m_data, m_size }; }
+
+        void format(FormatSink& builder, const Parameters&... parameters) const
+        {
+            usize index = 0;
+            (format_parameter(builder, m_placeholders[index++], parameters), ...);
+
+            append_literal(builder, m_trailing_literal);
+        }
+
+    private:
+        struct Literal {
+            usize m_offset = 0;
+            usize m_size = 0;
+
+            // The literal contains '{{' or '}}' and can not be copied directly.
+            bool m_escaped = false;
+        };
+
+        struct Placeholder {
+            Literal m_literal;
+            FormatSpecifier m_specifier;
+        };
+
+        consteval void parse()
+        {
+            constexpr bool is_integral[] = { false, Concepts::Integral<Parameters>... };
+
+            usize count = 0;
+            Literal literal;
+
+            for (usize offset = 0; offset < m_size;) {
+                char ch = m_data[offset];
+
+                if (ch == '}') {
+                    if (offset + 1 >= m_size || m_data[offset + 1] != '}')
+                        format_string_error("unmatched '}' in format string");
+
+                    literal.m_escaped = true;
+                    literal.m_size += 2;
+                    offset += 2;
+                    continue;
+                }
+
+                if (ch != '{') {
+                    ++literal.m_size;
+                    ++offset;
+                    continue;
+                }
+
+                if (offset + 1 < m_size && m_data[offset + 1] == '{') {
+                    literal.m_escaped = true;
+                    literal.m_size += 2;
+                    offset += 2;
+                    continue;
+                }
+
+                if (count >= sizeof...(Parameters))
+                    format_string_error("format string has more placeholders than parameters");
+
+                FormatSpecifier specifier;
+                offset = parse_placeholder(offset + 1, specifier);
+
+                if (!specifier.is_default() && !is_integral[count + 1])
+                    format_string_error("format specifier is only supported for integers");
+
+                m_placeholders[count++] = { literal, specifier };
+                literal = { offset, 0, false };
+            }
+
+            if (count != sizeof...(Parameters))
+                format_string_error("format string has fewer placeholders than parameters");
+
+            m_trailing_literal = literal;
+        }
+
+        // Returns the offset after the closing brace.
+        consteval usize parse_placeholder(usize offset, FormatSpecifier& specifier)
+        {
+            if (offset < m_size && m_data[offset] == ':') {
+                ++offset;
+
+                if (offset < m_size && m_data[offset] == '#') {
+                    specifier.m_prefix = true;
+                    ++offset;
+                }
+
+                if (offset < m_size && m_data[offset] == '0') {
+                    specifier.m_zero_pad = true;
+                    ++offset;
+                }
+
+                usize width = 0;
+                while (offset < m_size && m_data[offset] >= '0' && m_data[offset] <= '9') {
+                    width = width * 10 + (m_data[offset] - '0');
+                    ++offset;
+
+                    if (width > 255)
+                        format_string_error("format width must be smaller than 256");
+                }
+                specifier.m_width = static_cast<u8>(width);
+
+                if (offset < m_size && m_data[offset] == 'd') {
+                    specifier.m_base = FormatSpecifier::Base::Decimal;
+                    ++offset;
+                } else if (offset < m_size && m_data[offset] == 'x') {
+                    specifier.m_base = FormatSpecifier::Base::Hexadecimal;
+                    ++offset;
+                } else if (specifier.m_prefix) {
+                    specifier.m_base = FormatSpecifier::Base::Hexadecimal;
+                } else {
+                    specifier.m_base = FormatSpecifier::Base::Decimal;
+                }
+            }
+
+            if (offset >= m_size || m_data[offset] != '}')
+                format_string_error("invalid placeholder in format string");
+
+            return offset + 1;
+        }
+
+        void append_literal(FormatSink& builder, const Literal& literal) const;
+
+        template<typename T>
+        void format_parameter(FormatSink& builder, const Placeholder& placeholder, const T& value) const
+        {
+            append_literal(builder, placeholder.m_literal);
+
+            if constexpr (Concepts::Integral<T>) {
+                if (!placeholder.m_specifier.is_default()) {
+                    Formatter<T>::format(builder, value, placeholder.m_specifier);
+                    return;
+                }
+            }
+
+            Formatter<T>::format(builder, value);
+        }
+
+        const char *m_data;
+        usize m_size;
+
+        Placeholder m_placeholders[sizeof...(Parameters) + 1];
+        Literal m_trailing_literal;
+    };
+
+    class ImmutableStringInstance : public RefCounted<ImmutableStringInstance>, public PoolAllocated<ImmutableStringInstance> {
     public:
         ImmutableStringInstance()
         {
@@ -94,6 +321,7 @@ namespace Std
         {
             m_buffer = other.m_buffer;
             m_buffer_size = other.m_buffer_size;
+            m_hash = other.m_hash;
         }
         ~ImmutableStringInstance()
         {
@@ -106,28 +334,60 @@ namespace Std
             return m_buffer_size - 1;
         }
 
+        // Computed on first use, zero means that it was not computed yet.  If the hash is actually zero, it is
+        // computed every time.
+        u32 hash() const
+        {
+            if (m_hash == 0)
+                m_hash = StringView { data(), size() }.hash();
+            return m_hash;
+        }
+
     private:
         char *m_buffer;
         usize m_buffer_size;
+        mutable u32 m_hash = 0;
     };
 
     // Strings are immutable, that is very important.
+    //
+    // Short strings are stored inline, e.g. path components and directory entry names, this way they do not have to
+    // allocate an 'ImmutableStringInstance' and a buffer.  Longer strings share a reference counted instance.
+    // Strings that are never freed, e.g. names in flash, can be referenced without a copy with 'from_static'.
     class ImmutableString {
     public:
+        // This is what fits next to the marker in two words on the RP2040, e.g. 'bin', 'dev', 'tty' and 'heap'.
+        static constexpr usize inline_capacity = 7;
+
         ImmutableString()
-            : m_string_instance(ImmutableStringInstance::construct())
         {
-
+            set_inline("");
         }
 
         ImmutableString(StringView string)
-            : m_string_instance(ImmutableStringInstance::construct(string)) { }
+        {
+            if (string.size() <= inline_capacity)
+                set_inline(string);
+            else
+                set_instance(*ImmutableStringInstance::construct(string).leak_ref());
+        }
 
         ImmutableString(const char *string)
-            : m_string_instance(ImmutableStringInstance::construct(StringView{ string })) { }
+            : ImmutableString(StringView { string }) { }
 
         ImmutableString(const ImmutableString& other)
-            : m_string_instance(other.m_string_instance) { }
+        {
+            copy_from(other);
+        }
+        ImmutableString(ImmutableString&& other)
+        {
+            move_from(other);
+        }
+
+        ~ImmutableString()
+        {
+            release();
+        }
 
         void strcpy_to(Span<char> other) const
         {
@@ -135,17 +395,56 @@ namespace Std
         }
 
         template<typename... Parameters>
-        static ImmutableString format(StringView fmtstr, const Parameters&...);
+        static ImmutableString format(FormatString<typename TypeIdentity<Parameters>::Type...> fmtstr, const Parameters&...);
 
-        const char* data() const { return m_string_instance->data(); }
-        usize size() const { return m_string_instance->size(); }
+        // The string is referenced and not copied, it must not be modified or freed, ever.
+        static ImmutableString from_static(const char *string)
+        {
+            StringView view { string };
+            VERIFY(view.size() <= 0xffff);
+
+            ImmutableString result;
+            result.m_static.m_data = string;
+            result.m_static.m_size = static_cast<u16>(view.size());
+            result.set_marker(static_marker);
+            return result;
+        }
+
+        const char* data() const
+        {
+            if (is_inline())
+                return m_inline;
+            if (is_static())
+                return m_static.m_data;
+            return m_instance->data();
+        }
+        usize size() const
+        {
+            if (is_inline())
+                return inline_capacity - marker();
+            if (is_static())
+                return m_static.m_size;
+            return m_instance->size();
+        }
         const char* cstring() const { return data(); }
 
+        // Returns true if the characters are stored in the object itself and not in a shared instance.
+        bool is_inline() const { return marker() <= inline_capacity; }
+        bool is_static() const { return marker() == static_marker; }
+
         Span<const char> span() const { return { data(), size() }; }
         StringView view() const { return { data(), size() }; }
 
         operator StringView() const { return view(); }
 
+        // Equal to the hash of the 'StringView', it is only computed once for strings with a shared instance.
+        u32 hash() const
+        {
+            if (is_shared())
+                return m_instance->hash();
+            return view().hash();
+        }
+
         std::strong_ordering operator<=>(const ImmutableString& other) const { return view() <=> other.view(); }
 
         bool operator==(const ImmutableString& other) const
@@ -155,29 +454,103 @@ namespace Std
 
         ImmutableString& operator=(const ImmutableString& other)
         {
-            m_string_instance = other.m_string_instance;
+            if (this != &other) {
+                release();
+                copy_from(other);
+            }
+            return *this;
+        }
+        ImmutableString& operator=(ImmutableString&& other)
+        {
+            if (this != &other) {
+                release();
+                move_from(other);
+            }
             return *this;
         }
 
     private:
-        RefPtr<ImmutableStringInstance> m_string_instance;
+        // The last byte is 'inline_capacity - size()' for inline strings.  With 32-bit pointers, it follows the
+        // characters and doubles as null terminator if the inline storage is full.  There are no pointers into the
+        // object itself, it can be relocated with 'memcpy'.
+        static constexpr u8 instance_marker = 0xff;
+        static constexpr u8 static_marker = 0xfe;
+
+        // The size is limited, this way it does not overlap with the marker.
+        struct StaticString {
+            const char *m_data;
+            u16 m_size;
+        };
+        static_assert(inline_capacity < sizeof(StaticString));
+
+        u8 marker() const { return static_cast<u8>(m_inline[sizeof(m_inline) - 1]); }
+        void set_marker(u8 marker) { m_inline[sizeof(m_inline) - 1] = static_cast<char>(marker); }
+
+        bool is_shared() const { return marker() == instance_marker; }
+
+        void set_inline(StringView string)
+        {
+            string.strcpy_to({ m_inline, string.size() + 1 });
+            set_marker(static_cast<u8>(inline_capacity - string.size()));
+        }
+        void set_instance(ImmutableStringInstance& instance)
+        {
+            m_instance = &instance;
+            set_marker(instance_marker);
+        }
+
+        void copy_from(const ImmutableString& other)
+        {
+            __builtin_memcpy(m_inline, other.m_inline, sizeof(m_inline));
+            if (is_shared())
+                m_instance->ref();
+        }
+        void move_from(ImmutableString& other)
+        {
+            __builtin_memcpy(m_inline, other.m_inline, sizeof(m_inline));
+            other.set_inline("");
+        }
+
+        void release()
+        {
+            if (is_shared())
+                m_instance->unref();
+        }
+
+        union {
+            ImmutableStringInstance *m_instance;
+
+            StaticString m_static;
+            char m_inline[sizeof(StaticString)];
+        };
+    };
+
+    static_assert(sizeof(void*) != 4 || sizeof(ImmutableString) == 8);
+
+    template<>
+    struct IsTriviallyRelocatable<ImmutableString> : IntegralConstant<bool, true> {
     };
 
-    class StringBuilder {
+    // These methods hide the virtual calls of 'FormatSink' if the type is known.
+    class StringBuilder final : public FormatSink {
     public:
+        void write(StringView value) override
+        {
+            m_data.extend(value);
+        }
+
         void append(char value)
         {
             m_data.append(value);
         }
         void append(StringView value)
         {
-            for (char ch : value.iter())
-                m_data.append(ch);
+            m_data.extend(value);
         }
         template<typename... Parameters>
-        void appendf(StringView fmtstr, const Parameters&... parameters)
+        void appendf(FormatString<typename TypeIdentity<Parameters>::Type...> fmtstr, const Parameters&... parameters)
         {
-            vformat(*this, fmtstr, VariadicFormatParams { parameters... });
+            fmtstr.format(*this, parameters...);
         }
 
         char* data() { return m_data.data(); }
@@ -192,14 +565,31 @@ namespace Std
     };
 
     template<typename... Parameters>
-    ImmutableString ImmutableString::format(StringView fmtstr, const Parameters&... parameters)
+    ImmutableString ImmutableString::format(FormatString<typename TypeIdentity<Parameters>::Type...> fmtstr, const Parameters&... parameters)
     {
         StringBuilder builder;
-        builder.appendf(fmtstr, parameters...);
+        fmtstr.format(builder, parameters...);
         return builder.string();
     }
 
-    inline void vformat(StringBuilder& builder, StringView fmtstr, TypeErasedFormatParams params)
+    template<typename... Parameters>
+    void FormatString<Parameters...>::append_literal(FormatSink& builder, const Literal& literal) const
+    {
+        if (!literal.m_escaped) {
+            builder.append(StringView { m_data + literal.m_offset, literal.m_size });
+            return;
+        }
+
+        // The escape sequences were verified when parsing.
+        for (usize offset = literal.m_offset; offset < literal.m_offset + literal.m_size; ++offset) {
+            builder.append(m_data[offset]);
+
+            if (m_data[offset] == '{' || m_data[offset] == '}')
+                ++offset;
+        }
+    }
+
+    inline void vformat(FormatSink& builder, StringView fmtstr, TypeErasedFormatParams params)
     {
         usize next_parameter_index = 0;
         usize curly_brace_level = 0;
@@ -224,7 +614,7 @@ namespace Std
 
                 ASSERT(lexer.peek_or_null() != '}');
 
-                builder.append(lexer.consume());
+                builder.append(lexer.consume_until_any_of("{}"));
             } else {
                 if (lexer.try_consume('{')) {
                     ++curly_brace_level;
@@ -242,25 +632,37 @@ namespace Std
                     continue;
                 }
 
-                lexer.consume();
+                lexer.consume_until_any_of("{}");
             }
         }
     }
 
     void dbgln_raw(StringView);
 
-    template<typename... Parameters>
-    void dbgln(StringView fmtstr, const Parameters&... parameters)
-    {
-        StringBuilder builder;
-        vformat(builder, fmtstr, VariadicFormatParams { parameters... });
-        dbgln_raw(builder.view());
-    }
+    // Writes one line to the debug console in chunks, nothing is allocated.  The line is written as one piece, in the
+    // kernel interrupts are disabled until the sink is destroyed, thus formatters must not block.
+    class DebugFormatSink final : public FormatSink {
+    public:
+        DebugFormatSink();
+        ~DebugFormatSink();
+
+        void write(StringView) override;
+
+    private:
+        void flush();
+
+        char m_buffer[64];
+        usize m_size = 0;
+
+        bool m_enabled;
+        bool m_were_interrupts_enabled;
+    };
 
     template<typename... Parameters>
-    void dbgln(const char *fmtstr, const Parameters&... parameters)
+    void dbgln(FormatString<typename TypeIdentity<Parameters>::Type...> fmtstr, const Parameters&... parameters)
     {
-        return dbgln(StringView { fmtstr }, parameters...);
+        DebugFormatSink sink;
+        fmtstr.format(sink, parameters...);
     }
 
     inline void dbgln()
@@ -271,12 +673,13 @@ namespace Std
     template<typename T>
     requires Concepts::Integral<T>
     struct Formatter<T> {
-        static void format(StringBuilder&, T);
+        static void format(FormatSink&, T);
+        static void format(FormatSink&, T, const FormatSpecifier&);
     };
 
     template<typename T>
     struct Formatter<T*> {
-        static void format(StringBuilder& builder, const T *value)
+        static void format(FormatSink& builder, const T *value)
         {
             if constexpr(sizeof(T*) == 4) {
                 return Formatter<u32>::format(builder, reinterpret_cast<u32>(value));
@@ -295,7 +698,7 @@ namespace Std
 
     template<>
     struct Formatter<StringView> {
-        static void format(StringBuilder&, StringView);
+        static void format(FormatSink&, StringView);
     };
     template<>
     struct Formatter<ImmutableString> : Formatter<StringView> {
@@ -309,20 +712,20 @@ namespace Std
 
     template<>
     struct Formatter<bool> {
-        static void format(StringBuilder&, bool);
+        static void format(FormatSink&, bool);
     };
     template<>
     struct Formatter<char> {
-        static void format(StringBuilder&, char);
+        static void format(FormatSink&, char);
     };
 
     template<>
     struct Formatter<Path> {
-        static void format(StringBuilder&, const Path&);
+        static void format(FormatSink&, const Path&);
     };
     template<>
     struct Formatter<StringBuilder> {
-        static void format(StringBuilder& builder, const StringBuilder& value)
+        static void format(FormatSink& builder, const StringBuilder& value)
         {
             builder.append(value.view());
         }
@@ -330,7 +733,7 @@ namespace Std
 
     template<typename T>
     struct Formatter<Span<T>> {
-        static void format(StringBuilder& builder, Span<T> value)
+        static void format(FormatSink& builder, Span<T> value)
         {
             builder.appendf("({}, {})", value.data(), value.size());
         }
@@ -338,7 +741,7 @@ namespace Std
 
     template<typename T>
     struct Formatter<Optional<T>> {
-        static void format(StringBuilder& builder, const Optional<T>& value)
+        static void format(FormatSink& builder, const Optional<T>& value)
         {
             if (value.is_valid())
                 builder.appendf("{}", value.value());
@@ -12,6 +12,8 @@
 #elif defined(KERNEL)
 # include <Kernel/ConsoleDevice.hpp>
 # include <Kernel/HandlerMode.hpp>
+# include <Kernel/GlobalMemoryAllocator.hpp>
+# include <Kernel/PageAllocator.hpp>
 #endif
 
 namespace Std
@@ -48,6 +50,46 @@ namespace Std
 #endif
     }
 
+    bool try_expand_allocation(void *pointer, usize size)
+    {
+#if defined(TEST)
+        // The allocator of the host system does not offer this.
+        return false;
+#elif defined(KERNEL)
+        return Kernel::GlobalMemoryAllocator::the().try_expand(reinterpret_cast<u8*>(pointer), size, true, __builtin_return_address(0));
+#endif
+    }
+
+    u8* allocate_object_pool_page(usize power)
+    {
+#if defined(TEST)
+        return new u8[1 << power];
+#elif defined(KERNEL)
+        // The page is owned by the pool forever, thus we take it away from the 'OwnedPageRange'.
+        auto owned_range = Kernel::PageAllocator::the().allocate(power).must();
+        u8 *page = owned_range.data();
+        owned_range.m_range.clear();
+
+        return page;
+#endif
+    }
+
+    bool enter_object_pool_critical_section()
+    {
+#if defined(TEST)
+        return false;
+#elif defined(KERNEL)
+        return Kernel::disable_interrupts();
+#endif
+    }
+
+    void leave_object_pool_critical_section(bool were_interrupts_enabled)
+    {
+#if defined(KERNEL)
+        Kernel::restore_interrupts(were_interrupts_enabled);
+#endif
+    }
+
     void crash(const char *format, const char *condition, const char *file, usize line)
     {
         Std::Lexer lexer { format };
@@ -29,6 +29,12 @@ struct RemoveReference<T&> {
     using Type = T;
 };
 
+// Prevents template argument deduction from a parameter.
+template<typename T>
+struct TypeIdentity {
+    using Type = T;
+};
+
 template<typename T>
 constexpr typename RemoveReference<T>::Type&& move(T&& value)
 {
@@ -72,6 +78,8 @@ inline void strlcpy(char *destination, const char *source, usize size) noexcept
 }
 extern "C"
 void* memcpy(void *destination, const void *source, usize count) noexcept;
+extern "C"
+void* memmove(void *destination, const void *source, usize count) noexcept;
 
 template<typename T>
 constexpr T max(T a, T b)
@@ -110,7 +118,20 @@ namespace Std {
     class Path;
 
     template<typename... Parameters>
-    void dbgln(const char *fmtstr, const Parameters&...);
+    class FormatString;
+
+    template<typename... Parameters>
+    void dbgln(FormatString<typename TypeIdentity<Parameters>::Type...> fmtstr, const Parameters&...);
+
+    // Tries to resize memory that was allocated with 'operator new[]' without moving it.
+    bool try_expand_allocation(void *pointer, usize size);
+
+    // Provides memory for 'ObjectPool', this memory is never returned.
+    u8* allocate_object_pool_page(usize power);
+
+    // Protects 'ObjectPool' against concurrent access, this can be used in handler mode.
+    bool enter_object_pool_critical_section();
+    void leave_object_pool_critical_section(bool were_interrupts_enabled);
 
     [[noreturn]]
     void crash(const char *format, const char *condition, const char *file, usize line);
@@ -32,26 +32,45 @@ namespace Std
             m_hash.insert({ move(key), move(value) });
         }
 
-        Value* get(const Key& key)
+        // Looks up the value without copying the key, 'Lookup' can be any type that is hashed like 'Key'.
+        template<typename Lookup>
+        requires HashCompatible<Lookup, Key>
+        Value* find(const Lookup& key)
         {
-            Node *node = m_hash.search({ key, {} });
+            Node *node = m_hash.search(Hash<Lookup>::compute(key), [&](const Node& node) {
+                if constexpr (Concepts::Same<Lookup, Key>)
+                    return node.m_key == key;
+                else
+                    return static_cast<Lookup>(node.m_key) == key;
+            });
 
             if (node)
                 return &node->m_value.value();
             else
                 return nullptr;
         }
+        template<typename Lookup>
+        requires HashCompatible<Lookup, Key>
+        const Value* find(const Lookup& key) const
+        {
+            return const_cast<HashMap*>(this)->find(key);
+        }
+
+        Value* get(const Key& key)
+        {
+            return find(key);
+        }
         const Value* get(const Key& key) const
         {
-            return const_cast<HashMap*>(this)->get(key);
+            return find(key);
         }
 
         Optional<Value> get_opt(const Key& key) const
         {
-            const Node *node = m_hash.search({ key, {} });
+            const Value *value = find(key);
 
-            if (node)
-                return node->m_value;
+            if (value)
+                return *value;
             else
                 return {};
         }
@@ -65,6 +84,10 @@ namespace Std
         {
             return m_hash.size();
         }
+        usize capacity() const
+        {
+            return m_hash.capacity();
+        }
 
         struct Node {
             Key m_key;
@@ -72,6 +95,10 @@ namespace Std
 
             u32 hash() const { return Hash<Key>::compute(m_key); }
 
+            bool operator==(const Node& other) const
+            {
+                return m_key == other.m_key;
+            }
             bool operator<(const Node& other) const
             {
                 return m_key < other.m_key;
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <Std/SortedSet.hpp>
+#include <Std/Forward.hpp>
+#include <Std/StringBuilder.hpp>
 #include <Std/Concepts.hpp>
 
 namespace Std
@@ -42,18 +43,16 @@ namespace Std
     struct Hash<StringView> {
         static u32 compute(StringView value)
         {
-            // http://www.cse.yorku.ca/~oz/hash.html
-
-            u32 hash = 5381;
-
-            for (char ch : value.iter())
-                hash = ((hash << 5) + hash) + ch;
-
-            return hash;
+            return value.hash();
         }
     };
     template<>
     struct Hash<ImmutableString> : Hash<StringView> {
+        // Longer strings cache the hash in the shared instance.
+        static u32 compute(const ImmutableString& value)
+        {
+            return value.hash();
+        }
     };
 
     template<typename T>
@@ -65,99 +64,154 @@ namespace Std
         }
     };
 
+    // Another type can be used to look up keys, if it is hashed the same way, e.g. 'StringView' for 'ImmutableString'.
+    template<typename Lookup, typename Key>
+    concept HashCompatible = Concepts::Same<Lookup, Key> || __is_base_of(Hash<Lookup>, Hash<Key>);
+
+    // Robin Hood hashing with linear probing, the entries are stored in a single array.
+    // Each slot remembers the hash of its entry, thus most mismatches are found without comparing the entries.
+    // Entries that are further away from their home slot take precedence, this keeps probe sequences short and
+    // allows entries to be removed by shifting the following entries back, without leaving tombstones.
     template<typename T>
     class HashTable {
+    private:
+        struct Slot;
+
     public:
+        HashTable() = default;
+        ~HashTable()
+        {
+            clear();
+        }
+
+        HashTable(const HashTable&) = delete;
+
+        HashTable(HashTable&& other)
+        {
+            *this = move(other);
+        }
+
         void clear()
         {
-            m_set.clear();
+            for (usize index = 0; index < m_capacity; ++index) {
+                if (m_slots[index].is_used())
+                    m_slots[index].value().~T();
+            }
+
+            delete[] m_slots;
+
+            m_slots = nullptr;
+            m_capacity = 0;
+            m_size = 0;
         }
 
-        void insert(const T& value)
+        T& insert(const T& value)
         {
-            m_set.insert({ Hash<T>::compute(value), value });
+            return insert_impl(value);
         }
-        void insert(T&& value)
+        T& insert(T&& value)
         {
-            m_set.insert({ Hash<T>::compute(value), move(value) });
+            return insert_impl(move(value));
         }
 
         T* search(const T& value)
         {
-            Node *node = m_set.search({ Hash<T>::compute(value), value });
-
-            if (node)
-                return &node->m_value;
-            else
-                return nullptr;
+            return search(Hash<T>::compute(value), [&](const T& other) { return is_equal(other, value); });
         }
         const T* search(const T& value) const
         {
             return const_cast<HashTable*>(this)->search(value);
         }
 
-        void remove(const T& value)
+        // Finds the entry with this hash for which the predicate returns true, this is used for lookups with a
+        // different type than the entries.
+        template<typename Predicate>
+        T* search(u32 hash, Predicate&& predicate)
         {
-            m_set.remove({ Hash<T>::compute(value), value });
+            usize index = find_index(adjust_hash(hash), predicate);
+
+            if (index != npos)
+                return &m_slots[index].value();
+            else
+                return nullptr;
         }
 
-        usize size() const
+        void remove(const T& value)
         {
-            return m_set.size();
-        }
+            usize index = find_index(hash_of(value), [&](const T& other) { return is_equal(other, value); });
 
-        struct Node {
-            u32 m_hash;
-            T m_value;
+            if (index == npos)
+                return;
 
-            bool operator<(const Node& other) const
-            {
-                if (m_hash < other.m_hash)
-                    return true;
+            m_slots[index].value().~T();
+            m_slots[index].m_hash = 0;
+            --m_size;
 
-                if (m_hash > other.m_hash)
-                    return false;
+            // Move the following entries one slot back until we reach one that is already in its home slot.
+            for (;;) {
+                usize next = (index + 1) & mask();
+                Slot& slot = m_slots[next];
 
-                return m_value < other.m_value;
-            }
-            bool operator>(const Node& other) const
-            {
-                if (m_hash > other.m_hash)
-                    return true;
+                if (!slot.is_used() || probe_distance(next, slot.m_hash) == 0)
+                    break;
+
+                new (m_slots[index].m_storage) T { move(slot.value()) };
+                m_slots[index].m_hash = slot.m_hash;
 
-                if (m_hash < other.m_hash)
-                    return false;
+                slot.value().~T();
+                slot.m_hash = 0;
 
-                return m_value > other.m_value;
+                index = next;
             }
-        };
+        }
+
+        usize size() const { return m_size; }
+        usize capacity() const { return m_capacity; }
 
+        HashTable& operator=(HashTable&& other)
+        {
+            clear();
+
+            m_slots = exchange(other.m_slots, nullptr);
+            m_capacity = exchange(other.m_capacity, 0);
+            m_size = exchange(other.m_size, 0);
+
+            return *this;
+        }
+
+        // Inserting or removing entries may move other entries, iterators remain usable but may skip or repeat entries.
         class Iterator {
         public:
-            explicit Iterator(SortedSet<Node>::InorderIterator iterator)
-                : m_iterator(iterator)
+            Iterator(HashTable& table, usize index)
+                : m_table(&table)
+                , m_index(index)
             {
+                skip_unused_slots();
             }
 
-            Iterator begin() { return Iterator { m_iterator.begin() }; }
-            Iterator end() { return Iterator { m_iterator.end() }; }
+            Iterator begin() { return *this; }
+            Iterator end() { return Iterator { *m_table, m_table->m_capacity }; }
 
-            const T& operator*() const { return (*m_iterator).m_value; }
-            T& operator*() { return (*m_iterator).m_value; }
+            const T& operator*() const { return m_table->m_slots[m_index].value(); }
+            T& operator*() { return m_table->m_slots[m_index].value(); }
 
             Iterator& operator++()
             {
-                ++m_iterator;
+                ++m_index;
+                skip_unused_slots();
+
                 return *this;
             }
             Iterator operator++(int)
             {
-                return Iterator { m_iterator++ };
+                Iterator copy = *this;
+                operator++();
+                return copy;
             }
 
             bool operator==(Iterator other) const
             {
-                return m_iterator == other.m_iterator;
+                return min(m_index, m_table->m_capacity) == min(other.m_index, other.m_table->m_capacity);
             }
             bool operator!=(Iterator other) const
             {
@@ -165,12 +219,151 @@ namespace Std
             }
 
         private:
-            SortedSet<Node>::InorderIterator m_iterator;
+            HashTable *m_table;
+            usize m_index;
+
+            void skip_unused_slots()
+            {
+                while (m_index < m_table->m_capacity && !m_table->m_slots[m_index].is_used())
+                    ++m_index;
+            }
         };
 
-        Iterator iter() { return Iterator { m_set.inorder() }; }
+        Iterator iter() { return Iterator { *this, 0 }; }
 
     private:
-        SortedSet<Node> m_set;
+        static constexpr usize npos = -1;
+        static constexpr usize minimum_capacity = 8;
+
+        struct Slot {
+            // Zero marks an unused slot, 'hash_of' never returns zero.
+            u32 m_hash;
+            alignas(T) u8 m_storage[sizeof(T)];
+
+            bool is_used() const { return m_hash != 0; }
+
+            T& value() { return *reinterpret_cast<T*>(m_storage); }
+        };
+
+        Slot *m_slots = nullptr;
+        usize m_capacity = 0;
+        usize m_size = 0;
+
+        usize mask() const { return m_capacity - 1; }
+
+        static u32 adjust_hash(u32 hash)
+        {
+            return hash != 0 ? hash : 1;
+        }
+        static u32 hash_of(const T& value)
+        {
+            return adjust_hash(Hash<T>::compute(value));
+        }
+
+        // How far the entry in this slot is away from the slot that its hash refers to.
+        usize probe_distance(usize index, u32 hash) const
+        {
+            return (index - (hash & mask())) & mask();
+        }
+
+        static bool is_equal(const T& lhs, const T& rhs)
+        {
+            if constexpr (requires { { lhs == rhs } -> Concepts::Same<bool>; })
+                return lhs == rhs;
+            else
+                return !(lhs < rhs) && !(lhs > rhs);
+        }
+
+        template<typename Predicate>
+        usize find_index(u32 hash, Predicate&& predicate)
+        {
+            if (m_size == 0)
+                return npos;
+
+            usize index = hash & mask();
+            for (usize distance = 0;; ++distance, index = (index + 1) & mask()) {
+                Slot& slot = m_slots[index];
+
+                // If our entry was present, it would have taken this slot.
+                if (!slot.is_used() || probe_distance(index, slot.m_hash) < distance)
+                    return npos;
+
+                if (slot.m_hash == hash && predicate(slot.value()))
+                    return index;
+            }
+        }
+
+        template<typename T_>
+        T& insert_impl(T_&& value)
+        {
+            u32 hash = hash_of(value);
+
+            usize index = find_index(hash, [&](const T& other) { return is_equal(other, value); });
+            if (index != npos) {
+                m_slots[index].value() = forward<T_>(value);
+                return m_slots[index].value();
+            }
+
+            // Keep the load factor below 3/4, otherwise the probe sequences become long.
+            if ((m_size + 1) * 4 > m_capacity * 3)
+                rehash(max(m_capacity * 2, minimum_capacity));
+
+            return insert_new_entry(hash, T { forward<T_>(value) });
+        }
+
+        T& insert_new_entry(u32 hash, T&& value)
+        {
+            T *inserted_value = nullptr;
+
+            usize index = hash & mask();
+            for (usize distance = 0;; ++distance, index = (index + 1) & mask()) {
+                Slot& slot = m_slots[index];
+
+                if (!slot.is_used()) {
+                    new (slot.m_storage) T { move(value) };
+                    slot.m_hash = hash;
+                    ++m_size;
+
+                    return inserted_value != nullptr ? *inserted_value : slot.value();
+                }
+
+                // Take the slot from an entry that is closer to its home and continue with that entry instead.
+                usize existing_distance = probe_distance(index, slot.m_hash);
+                if (existing_distance < distance) {
+                    swap(hash, slot.m_hash);
+                    swap(value, slot.value());
+
+                    if (inserted_value == nullptr)
+                        inserted_value = &slot.value();
+
+                    distance = existing_distance;
+                }
+            }
+        }
+
+        void rehash(usize new_capacity)
+        {
+            Slot *old_slots = m_slots;
+            usize old_capacity = m_capacity;
+
+            m_slots = new Slot[new_capacity];
+            m_capacity = new_capacity;
+            m_size = 0;
+
+            for (usize index = 0; index < m_capacity; ++index)
+                m_slots[index].m_hash = 0;
+
+            for (usize index = 0; index < old_capacity; ++index) {
+                Slot& slot = old_slots[index];
+
+                if (!slot.is_used())
+                    continue;
+
+                insert_new_entry(slot.m_hash, move(slot.value()));
+                slot.value().~T();
+            }
+
+            delete[] old_slots;
+        }
     };
 }
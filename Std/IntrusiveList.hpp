@@ -0,0 +1,219 @@
+#pragma once
+
+#include <Std/Forward.hpp>
+#include <Std/RefPtr.hpp>
+
+namespace Std
+{
+    // This is embedded in the objects that are put into an 'IntrusiveList', an object can be in one list per node.
+    template<typename T>
+    struct IntrusiveListNode {
+        T *m_next = nullptr;
+        T *m_previous = nullptr;
+
+        // The list this node is linked into, this is used to verify that objects are removed from the correct list.
+        void *m_list = nullptr;
+
+        bool is_linked() const { return m_list != nullptr; }
+    };
+
+    // Doubly linked list that uses the node in the objects, thus nothing is allocated and there is no capacity limit.
+    // The list does not own the objects, they must stay alive while they are linked.
+    template<typename T, IntrusiveListNode<T> T::*Member>
+    class IntrusiveList {
+    public:
+        IntrusiveList() = default;
+        ~IntrusiveList()
+        {
+            clear();
+        }
+
+        IntrusiveList(const IntrusiveList&) = delete;
+        IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+        void enqueue(T& object)
+        {
+            IntrusiveListNode<T>& node = object.*Member;
+            VERIFY(!node.is_linked());
+
+            node.m_list = this;
+            node.m_next = nullptr;
+            node.m_previous = m_back;
+
+            if (m_back != nullptr)
+                (m_back->*Member).m_next = &object;
+            else
+                m_front = &object;
+
+            m_back = &object;
+            ++m_size;
+        }
+
+        void enqueue_front(T& object)
+        {
+            IntrusiveListNode<T>& node = object.*Member;
+            VERIFY(!node.is_linked());
+
+            node.m_list = this;
+            node.m_next = m_front;
+            node.m_previous = nullptr;
+
+            if (m_front != nullptr)
+                (m_front->*Member).m_previous = &object;
+            else
+                m_back = &object;
+
+            m_front = &object;
+            ++m_size;
+        }
+
+        T& dequeue()
+        {
+            T& object = front();
+            remove(object);
+            return object;
+        }
+
+        void remove(T& object)
+        {
+            IntrusiveListNode<T>& node = object.*Member;
+            VERIFY(node.m_list == this);
+
+            if (node.m_previous != nullptr)
+                (node.m_previous->*Member).m_next = node.m_next;
+            else
+                m_front = node.m_next;
+
+            if (node.m_next != nullptr)
+                (node.m_next->*Member).m_previous = node.m_previous;
+            else
+                m_back = node.m_previous;
+
+            node.m_next = nullptr;
+            node.m_previous = nullptr;
+            node.m_list = nullptr;
+
+            --m_size;
+        }
+
+        bool contains(const T& object) const
+        {
+            return (object.*Member).m_list == this;
+        }
+
+        T& front()
+        {
+            VERIFY(m_front != nullptr);
+            return *m_front;
+        }
+        T& back()
+        {
+            VERIFY(m_back != nullptr);
+            return *m_back;
+        }
+
+        usize size() const { return m_size; }
+        bool is_empty() const { return m_size == 0; }
+
+        void clear()
+        {
+            while (m_front != nullptr)
+                remove(*m_front);
+        }
+
+        class Iterator {
+        public:
+            explicit Iterator(T *current)
+                : m_current(current)
+            {
+            }
+
+            Iterator begin() { return *this; }
+            Iterator end() { return Iterator { nullptr }; }
+
+            T& operator*() { return *m_current; }
+
+            Iterator& operator++()
+            {
+                m_current = (m_current->*Member).m_next;
+                return *this;
+            }
+
+            bool operator==(const Iterator& other) const
+            {
+                return m_current == other.m_current;
+            }
+            bool operator!=(const Iterator& other) const
+            {
+                return !operator==(other);
+            }
+
+        private:
+            T *m_current;
+        };
+
+        // The current object must not be removed while iterating.
+        Iterator iter() { return Iterator { m_front }; }
+
+    private:
+        T *m_front = nullptr;
+        T *m_back = nullptr;
+        usize m_size = 0;
+    };
+
+    // Like 'IntrusiveList' but each linked object holds a reference.  The reference is moved into and out of the
+    // list, thus enqueueing and dequeueing does not change the reference count.
+    template<typename T, IntrusiveListNode<T> T::*Member>
+    class IntrusiveRefList {
+    public:
+        IntrusiveRefList() = default;
+        ~IntrusiveRefList()
+        {
+            clear();
+        }
+
+        IntrusiveRefList(const IntrusiveRefList&) = delete;
+        IntrusiveRefList& operator=(const IntrusiveRefList&) = delete;
+
+        void enqueue(RefPtr<T> object)
+        {
+            m_list.enqueue(*object.leak_ref());
+        }
+        void enqueue_front(RefPtr<T> object)
+        {
+            m_list.enqueue_front(*object.leak_ref());
+        }
+
+        RefPtr<T> dequeue()
+        {
+            return RefPtr<T>::adopt_ref(m_list.dequeue());
+        }
+
+        RefPtr<T> remove(T& object)
+        {
+            m_list.remove(object);
+            return RefPtr<T>::adopt_ref(object);
+        }
+
+        bool contains(const T& object) const { return m_list.contains(object); }
+
+        T& front() { return m_list.front(); }
+        T& back() { return m_list.back(); }
+
+        usize size() const { return m_list.size(); }
+        bool is_empty() const { return m_list.is_empty(); }
+
+        void clear()
+        {
+            while (!m_list.is_empty())
+                dequeue();
+        }
+
+        using Iterator = typename IntrusiveList<T, Member>::Iterator;
+
+        Iterator iter() { return m_list.iter(); }
+
+    private:
+        IntrusiveList<T, Member> m_list;
+    };
+}
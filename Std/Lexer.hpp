@@ -25,7 +25,9 @@ namespace Std
         }
         char peek_or_null()
         {
-            return peek().value_or(0);
+            if (eof())
+                return 0;
+            return m_input[m_offset];
         }
 
         char consume()
@@ -48,10 +50,8 @@ namespace Std
             if (str.size() > remaining())
                 return false;
 
-            for (usize i = 0; i < str.size(); ++i) {
-                if (m_input[m_offset + i] != str[i])
-                    return false;
-            }
+            if (compare_bytes(m_input.data() + m_offset, str.data(), str.size()) != 0)
+                return false;
 
             m_offset += str.size();
             return true;
@@ -60,17 +60,73 @@ namespace Std
         StringView consume_until(char ch)
         {
             usize offset = m_offset;
+            m_offset += find_byte(m_input.data() + m_offset, static_cast<u8>(ch), remaining());
+            return m_input.substr(offset, m_offset);
+        }
+        StringView consume_until_any_of(StringView delimiters)
+        {
+            usize offset = m_offset;
+            m_offset += scan(delimiters, true);
+            return m_input.substr(offset, m_offset);
+        }
 
-            while(!eof() && peek_or_null() != ch)
-                consume();
-
-
+        StringView consume_while(char ch)
+        {
+            usize offset = m_offset;
+            m_offset += scan(StringView { &ch, 1 }, false);
+            return m_input.substr(offset, m_offset);
+        }
+        StringView consume_while_any_of(StringView characters)
+        {
+            usize offset = m_offset;
+            m_offset += scan(characters, false);
             return m_input.substr(offset, m_offset);
         }
 
         usize remaining() const { return m_input.size() - m_offset; }
 
     private:
+        // Returns how many of the remaining characters can be skipped until a character that is in 'set' is found, if
+        // 'stop_at_member' is set, or until a character that is not in 'set' is found otherwise.  Aligned words are
+        // checked against every character of the set at once, this is meant for small sets.
+        usize scan(StringView set, bool stop_at_member) const
+        {
+            const char *data = m_input.data() + m_offset;
+            usize count = remaining();
+            usize offset = 0;
+
+            auto stops_at = [&](char character) {
+                bool is_member = false;
+                for (usize index = 0; index < set.size(); ++index)
+                    is_member |= set[index] == character;
+                return is_member == stop_at_member;
+            };
+
+            for (usize head = bytes_until_word_aligned(data, count); offset < head; ++offset) {
+                if (stops_at(data[offset]))
+                    return offset;
+            }
+
+            for (; offset + sizeof(BulkWord) <= count; offset += sizeof(BulkWord)) {
+                BulkWord word = *reinterpret_cast<const BulkWord*>(data + offset);
+
+                BulkWord members = 0;
+                for (usize index = 0; index < set.size(); ++index)
+                    members |= zero_byte_mask(word ^ broadcast_byte(static_cast<u8>(set[index])));
+
+                BulkWord stops = stop_at_member ? members : members ^ broadcast_byte(0x80);
+                if (stops != 0)
+                    return offset + first_marked_byte(stops);
+            }
+
+            for (; offset < count; ++offset) {
+                if (stops_at(data[offset]))
+                    return offset;
+            }
+
+            return count;
+        }
+
         StringView m_input;
         usize m_offset = 0;
     };
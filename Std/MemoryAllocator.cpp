@@ -10,12 +10,67 @@ namespace Std
         return size;
     }
 
+    static u32 find_first_set(u32 value)
+    {
+        return __builtin_ctz(value);
+    }
+    static u32 find_last_set(u32 value)
+    {
+        return 31 - __builtin_clz(value);
+    }
+
+    void MemoryTraceBuffer::append(const MemoryTraceRecord& record)
+    {
+        if (m_size == m_records.size()) {
+            m_oldest = (m_oldest + 1) % m_records.size();
+            --m_size;
+            ++m_overwritten;
+        }
+
+        m_records[(m_oldest + m_size) % m_records.size()] = record;
+        ++m_size;
+    }
+
+    usize MemoryTraceBuffer::drain(Span<MemoryTraceRecord> output)
+    {
+        usize count = min(m_size, output.size());
+
+        for (usize index = 0; index < count; ++index) {
+            output[index] = m_records[m_oldest];
+
+            m_oldest = (m_oldest + 1) % m_records.size();
+            --m_size;
+        }
+
+        return count;
+    }
+
     MemoryAllocator::MemoryAllocator(Bytes heap)
         : m_heap(heap)
     {
-        m_freelist = reinterpret_cast<Node*>(heap.data());
-        m_freelist->m_size = heap.size() - sizeof(Node);
-        m_freelist->m_next = nullptr;
+        VERIFY(usize(m_heap.data()) % 4 == 0);
+
+        m_heap.set_size(m_heap.size() - m_heap.size() % 4);
+        VERIFY(m_heap.size() < (1 << maximum_heap_power));
+        VERIFY(m_heap.size() >= minimum_block_size + block_header_size);
+
+        for (u32 first_level = 0; first_level < first_level_count; ++first_level) {
+            m_second_level_bitmaps[first_level] = 0;
+
+            for (u32 second_level = 0; second_level < second_level_count; ++second_level)
+                m_free_lists[first_level][second_level] = null_block;
+        }
+
+        // The last word of the heap is used as a sentinel, it looks like a used block without size.
+        // This way, we never have to check if the next block is beyond the end of the heap.
+        u32 sentinel = m_heap.size() - block_header_size;
+        block(sentinel).m_size_and_flags = 0;
+
+        block(0).m_size_and_flags = 0;
+        set_block_size(0, sentinel);
+        set_free(0, true);
+
+        insert_free_block(0);
     }
 
     u8* MemoryAllocator::allocate(usize size, bool debug_override, void *address)
@@ -23,37 +78,32 @@ namespace Std
         if (address == nullptr)
             address = __builtin_return_address(0);
 
-        Node *previous = nullptr;
-        for (Node *entry = m_freelist; entry; entry = entry->m_next)
-        {
-            if (entry->m_size >= size + sizeof(Node))
-            {
-                auto *next = reinterpret_cast<Node*>(entry->m_data + round_to_word(size));
-                next->m_next = entry->m_next;
-                next->m_size = entry->m_size - round_to_word(size) - sizeof(Node);
-
-                if (previous)
-                    previous->m_next = next;
-                else
-                    m_freelist = next;
+        u32 adjusted_size = adjust_request_size(size);
 
-                entry->m_next = nullptr;
-                entry->m_size = round_to_word(size);
+        u32 first_level, second_level;
+        u32 offset = null_block;
+        if (mapping_search(adjusted_size, first_level, second_level))
+            offset = find_suitable_block(first_level, second_level);
 
-                VERIFY(usize(entry->m_data) % 4 == 0);
+        if (offset == null_block) {
+            dump();
+            VERIFY_NOT_REACHED();
+        }
 
-                if (m_debug && debug_override)
-                    dbgln("\e[32mMTRACE: @ {} + {} {}\e[0m", address, entry->m_data, size);
+        remove_free_block(offset);
+        split_free_block(offset, adjusted_size);
 
-                return entry->m_data;
-            }
+        set_free(offset, false);
+        account_allocation(offset, address);
 
-            previous = entry;
-        }
+        VERIFY(usize(payload(offset)) % 4 == 0);
 
-        dump();
+        if (m_debug && debug_override)
+            dbgln("\e[32mMTRACE: @ {} + {} {}\e[0m", address, payload(offset), size);
+        if (debug_override)
+            trace(MemoryTraceOperation::Allocate, address, payload(offset), size);
 
-        VERIFY_NOT_REACHED();
+        return payload(offset);
     }
 
     void MemoryAllocator::deallocate(u8 *pointer, bool debug_override, void *address)
@@ -66,47 +116,13 @@ namespace Std
 
         if (m_debug && debug_override)
             dbgln("\e[32mMTRACE: @ {} - {}", address, pointer);
+        if (debug_override)
+            trace(MemoryTraceOperation::Deallocate, address, pointer);
 
-        auto *target_entry = reinterpret_cast<Node*>((u8*)pointer - sizeof(Node));
-
-        Node *previous = nullptr;
-        for (auto *entry = m_freelist; entry; entry = entry->m_next)
-        {
-            if (entry > target_entry)
-            {
-                // Try to merge on the left
-                if (previous && previous->m_data + previous->m_size == (u8*)target_entry) {
-                    previous->m_size += sizeof(Node) + target_entry->m_size;
-
-                    // Additionally, try to merge on the right
-                    if (previous->m_data + previous->m_size == (u8*)entry) {
-                        previous->m_size += sizeof(Node) + entry->m_size;
-                        previous->m_next = entry->m_next;
-                    }
-
-                    return;
-                }
-
-                // Try to merge on the right
-                if (target_entry->m_data + target_entry->m_size == (u8*)entry) {
-                    target_entry->m_size += sizeof(Node) + entry->m_size;
-                    target_entry->m_next = entry->m_next;
-                } else {
-                    target_entry->m_next = entry;
-                }
-
-                if (previous)
-                    previous->m_next = target_entry;
-                else
-                    m_freelist = target_entry;
-
-                return;
-            }
-
-            previous = entry;
-        }
+        u32 offset = offset_from_payload(pointer);
 
-        m_freelist = target_entry;
+        account_deallocation(offset);
+        free_block(offset);
     }
 
     u8* MemoryAllocator::reallocate(u8 *pointer, usize size, bool debug_override, void *address)
@@ -114,24 +130,474 @@ namespace Std
         if (address == nullptr)
             address = __builtin_return_address(0);
 
+        if (pointer == nullptr)
+            return allocate(size, debug_override, address);
+
         if (m_debug && debug_override)
             dbgln("\e[32mMTRACE: @ {} < {}\e[0m", address, pointer);
+        if (debug_override)
+            trace(MemoryTraceOperation::ReallocateFrom, address, pointer);
+
+        u32 offset = offset_from_payload(pointer);
+        u32 old_size = usable_size(offset);
+
+        u8 *new_pointer = pointer;
+        if (expand_used_block(offset, adjust_request_size(size))) {
+            account_resize(offset, old_size);
+        } else {
+            new_pointer = allocate(size, false, address);
+            memcpy(new_pointer, pointer, old_size);
+            deallocate(pointer, false, address);
+        }
+
+        if (m_debug && debug_override)
+            dbgln("\e[32mMTRACE: @ {} > {} {}\e[0m", address, new_pointer, size);
+        if (debug_override)
+            trace(MemoryTraceOperation::ReallocateTo, address, new_pointer, size);
+
+        return new_pointer;
+    }
+
+    bool MemoryAllocator::try_expand(u8 *pointer, usize size, bool debug_override, void *address)
+    {
+        if (pointer == nullptr)
+            return false;
+
+        if (address == nullptr)
+            address = __builtin_return_address(0);
 
-        auto *entry = reinterpret_cast<Node*>((u8*)pointer - sizeof(Node));
+        u32 offset = offset_from_payload(pointer);
+        u32 old_size = usable_size(offset);
 
-        if (size < entry->m_size) {
-            if (m_debug && debug_override)
-                dbgln("\e[32mMTRACE: @ {} > {} {}\e[0m", address, pointer, size);
+        if (!expand_used_block(offset, adjust_request_size(size)))
+            return false;
 
-            return pointer;
+        account_resize(offset, old_size);
+
+        // The heap changed, this has to show up in the trace, otherwise a replay would diverge from here on.
+        if (m_debug && debug_override) {
+            dbgln("\e[32mMTRACE: @ {} < {}\e[0m", address, pointer);
+            dbgln("\e[32mMTRACE: @ {} > {} {}\e[0m", address, pointer, size);
+        }
+        if (debug_override) {
+            trace(MemoryTraceOperation::ReallocateFrom, address, pointer);
+            trace(MemoryTraceOperation::ReallocateTo, address, pointer, size);
         }
 
-        u8 *new_pointer = allocate(size, false);
-        memcpy(new_pointer, pointer, entry->m_size);
-        deallocate(pointer, false);
+        return true;
+    }
+
+    void MemoryAllocator::dump()
+    {
+        dbgln("free lists:");
+        for (u32 first_level = 0; first_level < first_level_count; ++first_level) {
+            for (u32 second_level = 0; second_level < second_level_count; ++second_level) {
+                u32 offset = m_free_lists[first_level][second_level];
 
-        dbgln("\e[32mMTRACE: @ {} > {} {}\e[0m", address, new_pointer, size);
+                if (offset == null_block)
+                    continue;
 
-        return new_pointer;
+                dbgln("  [{}][{}]:", first_level, second_level);
+                for (; offset != null_block; offset = block(offset).m_next_free)
+                    dbgln("    {} ({} bytes)", payload(offset), usable_size(offset));
+            }
+        }
+
+        auto stats = statistics();
+
+        dbgln("statistics:");
+        dbgln("  m_largest_continous_block {}", stats.m_largest_continous_block);
+        dbgln("  m_avaliable_memory        {}", stats.m_avaliable_memory);
+    }
+
+    void MemoryAllocator::dump_trace()
+    {
+        MemoryTraceRecord records[8];
+
+        // Only dump what is there now, printing may cause more records to be added.
+        usize remaining = m_trace_buffer.size();
+        while (remaining > 0) {
+            usize count = m_trace_buffer.drain({ records, min<usize>(remaining, 8) });
+
+            for (usize index = 0; index < count; ++index)
+                dump_trace_record(records[index]);
+
+            remaining -= count;
+        }
+    }
+
+    void MemoryAllocator::dump_trace_record(const MemoryTraceRecord& record)
+    {
+        StringBuilder builder;
+        builder.append(memory_trace_dump_prefix);
+
+        auto *bytes = reinterpret_cast<const u8*>(&record);
+        for (usize index = 0; index < sizeof(record); ++index) {
+            builder.append("0123456789abcdef"[bytes[index] / 16]);
+            builder.append("0123456789abcdef"[bytes[index] % 16]);
+        }
+
+        dbgln("{}", builder);
+    }
+
+    void MemoryAllocator::trace(MemoryTraceOperation operation, void *caller, void *pointer, usize size)
+    {
+        if (!m_trace_buffer.is_enabled())
+            return;
+
+        MemoryTraceRecord record;
+        record.m_timestamp = trace_timestamp();
+        record.m_operation = operation;
+        record.m_caller = u32(uptr(caller));
+        record.m_pointer = u32(uptr(pointer));
+        record.m_size = size;
+
+        m_trace_buffer.append(record);
+    }
+
+    void MemoryAllocator::set_call_site_table(Span<CallSite> call_sites)
+    {
+        // Used blocks refer to entries in this table, thus it can not be replaced.
+        VERIFY(m_call_sites.is_empty());
+
+        VERIFY(call_sites.size() <= maximum_call_sites);
+        VERIFY((call_sites.size() & (call_sites.size() - 1)) == 0);
+
+        for (usize index = 0; index < call_sites.size(); ++index)
+            call_sites[index] = CallSite { 0, 0, 0, 0, 0 };
+
+        m_call_sites = call_sites;
+    }
+
+    void MemoryAllocator::dump_call_sites()
+    {
+        dbgln("call sites:");
+
+        usize live_bytes = 0;
+        for (usize index = 0; index < m_call_sites.size(); ++index) {
+            CallSite& call_site = m_call_sites[index];
+
+            if (call_site.m_caller == 0)
+                continue;
+
+            dump_call_site(call_site);
+            live_bytes += call_site.m_live_bytes;
+        }
+
+        dbgln("  {} bytes accounted, {} allocations not accounted", live_bytes, m_unaccounted_allocations);
+    }
+
+    void MemoryAllocator::dump_call_site(const CallSite& call_site)
+    {
+        dbgln("  {}: {} bytes in {} allocations (peak {} bytes, {} allocations in total)",
+            reinterpret_cast<void*>(call_site.m_caller),
+            call_site.m_live_bytes,
+            call_site.m_live_allocations,
+            call_site.m_peak_bytes,
+            call_site.m_allocations);
+    }
+
+    MemoryAllocator::Statistics MemoryAllocator::statistics()
+    {
+        Statistics stats;
+
+        stats.m_largest_continous_block = 0;
+        stats.m_avaliable_memory = 0;
+
+        for (u32 offset = 0; block_size(offset) != 0; offset += block_size(offset)) {
+            if (!is_free(offset))
+                continue;
+
+            stats.m_avaliable_memory += usable_size(offset);
+
+            if (usable_size(offset) > stats.m_largest_continous_block)
+                stats.m_largest_continous_block = usable_size(offset);
+        }
+
+        return stats;
+    }
+
+    void MemoryAllocator::set_block_size(u32 offset, u32 size)
+    {
+        VERIFY((size & ~block_size_mask) == 0);
+        block(offset).m_size_and_flags = size | (block(offset).m_size_and_flags & ~block_size_mask);
+    }
+
+    void MemoryAllocator::set_free(u32 offset, bool free)
+    {
+        if (free) {
+            block(offset).m_size_and_flags |= block_is_free;
+            footer(offset) = block_size(offset);
+        } else {
+            block(offset).m_size_and_flags &= ~block_is_free;
+        }
+
+        set_previous_free(offset + block_size(offset), free);
+    }
+
+    void MemoryAllocator::set_previous_free(u32 offset, bool free)
+    {
+        if (free)
+            block(offset).m_size_and_flags |= previous_block_is_free;
+        else
+            block(offset).m_size_and_flags &= ~previous_block_is_free;
+    }
+
+    u32 MemoryAllocator::offset_from_payload(u8 *pointer)
+    {
+        VERIFY(pointer >= m_heap.data() + block_header_size);
+        VERIFY(pointer < m_heap.data() + m_heap.size());
+
+        return pointer - m_heap.data() - block_header_size;
+    }
+
+    u32 MemoryAllocator::adjust_request_size(usize size)
+    {
+        return max<usize>(round_to_word(size) + block_header_size, minimum_block_size);
+    }
+
+    void MemoryAllocator::mapping_insert(u32 size, u32& first_level, u32& second_level)
+    {
+        if (size < small_block_size) {
+            first_level = 0;
+            second_level = size / (small_block_size / second_level_count);
+        } else {
+            u32 power = find_last_set(size);
+
+            first_level = power - first_level_shift + 1;
+            second_level = (size >> (power - second_level_power)) ^ second_level_count;
+        }
+    }
+
+    bool MemoryAllocator::mapping_search(u32 size, u32& first_level, u32& second_level)
+    {
+        // Round up to the next list, this ensures that every block in that list is large enough.
+        if (size >= small_block_size)
+            size += (1 << (find_last_set(size) - second_level_power)) - 1;
+
+        mapping_insert(size, first_level, second_level);
+
+        return first_level < first_level_count;
+    }
+
+    u32 MemoryAllocator::find_suitable_block(u32 first_level, u32 second_level)
+    {
+        u32 second_level_bitmap = m_second_level_bitmaps[first_level] & (~0u << second_level);
+
+        if (second_level_bitmap == 0) {
+            u32 first_level_bitmap = m_first_level_bitmap & (~0u << (first_level + 1));
+
+            if (first_level_bitmap == 0)
+                return null_block;
+
+            first_level = find_first_set(first_level_bitmap);
+            second_level_bitmap = m_second_level_bitmaps[first_level];
+        }
+
+        second_level = find_first_set(second_level_bitmap);
+        return m_free_lists[first_level][second_level];
+    }
+
+    void MemoryAllocator::insert_free_block(u32 offset)
+    {
+        u32 first_level, second_level;
+        mapping_insert(block_size(offset), first_level, second_level);
+
+        u32 head = m_free_lists[first_level][second_level];
+
+        block(offset).m_next_free = head;
+        block(offset).m_previous_free = null_block;
+
+        if (head != null_block)
+            block(head).m_previous_free = offset;
+
+        m_free_lists[first_level][second_level] = offset;
+
+        m_first_level_bitmap |= 1 << first_level;
+        m_second_level_bitmaps[first_level] |= 1 << second_level;
+    }
+
+    void MemoryAllocator::remove_free_block(u32 offset)
+    {
+        u32 first_level, second_level;
+        mapping_insert(block_size(offset), first_level, second_level);
+
+        u32 next = block(offset).m_next_free;
+        u32 previous = block(offset).m_previous_free;
+
+        if (next != null_block)
+            block(next).m_previous_free = previous;
+
+        if (previous != null_block) {
+            block(previous).m_next_free = next;
+            return;
+        }
+
+        VERIFY(m_free_lists[first_level][second_level] == offset);
+        m_free_lists[first_level][second_level] = next;
+
+        if (next == null_block) {
+            m_second_level_bitmaps[first_level] &= ~(1 << second_level);
+
+            if (m_second_level_bitmaps[first_level] == 0)
+                m_first_level_bitmap &= ~(1 << first_level);
+        }
+    }
+
+    void MemoryAllocator::split_free_block(u32 offset, u32 size)
+    {
+        VERIFY(block_size(offset) >= size);
+
+        u32 remaining_size = block_size(offset) - size;
+
+        // If the remainder is too small to hold a free block, it stays part of this block.
+        if (remaining_size < minimum_block_size)
+            return;
+
+        set_block_size(offset, size);
+
+        u32 remainder = offset + size;
+        block(remainder).m_size_and_flags = previous_block_is_free;
+        set_block_size(remainder, remaining_size);
+        set_free(remainder, true);
+
+        insert_free_block(remainder);
+    }
+
+    u32 MemoryAllocator::find_call_site(void *caller)
+    {
+        u32 mask = m_call_sites.size() - 1;
+        u32 index = (u32(uptr(caller)) >> 1) * 2654435761u & mask;
+
+        // Entries are never removed, thus we can stop at the first empty entry.
+        for (usize probe = 0; probe < m_call_sites.size(); ++probe, index = (index + 1) & mask) {
+            CallSite& call_site = m_call_sites[index];
+
+            if (call_site.m_caller == uptr(caller))
+                return index + 1;
+
+            if (call_site.m_caller == 0) {
+                call_site.m_caller = uptr(caller);
+                return index + 1;
+            }
+        }
+
+        return 0;
+    }
+
+    void MemoryAllocator::account_allocation(u32 offset, void *caller)
+    {
+        if (m_call_sites.is_empty())
+            return;
+
+        u32 index = find_call_site(caller);
+        if (index == 0) {
+            ++m_unaccounted_allocations;
+            return;
+        }
+
+        block(offset).m_size_and_flags |= index << call_site_shift;
+
+        CallSite& call_site = m_call_sites[index - 1];
+        call_site.m_live_bytes += usable_size(offset);
+        call_site.m_live_allocations += 1;
+        call_site.m_allocations += 1;
+        call_site.m_peak_bytes = max(call_site.m_peak_bytes, call_site.m_live_bytes);
+    }
+
+    void MemoryAllocator::account_deallocation(u32 offset)
+    {
+        u32 index = call_site_index(offset);
+        if (index == 0)
+            return;
+
+        CallSite& call_site = m_call_sites[index - 1];
+        call_site.m_live_bytes -= usable_size(offset);
+        call_site.m_live_allocations -= 1;
+    }
+
+    void MemoryAllocator::account_resize(u32 offset, u32 old_usable_size)
+    {
+        u32 index = call_site_index(offset);
+        if (index == 0)
+            return;
+
+        CallSite& call_site = m_call_sites[index - 1];
+        call_site.m_live_bytes = call_site.m_live_bytes - old_usable_size + usable_size(offset);
+        call_site.m_peak_bytes = max(call_site.m_peak_bytes, call_site.m_live_bytes);
+    }
+
+    void MemoryAllocator::free_block(u32 offset)
+    {
+        VERIFY(!is_free(offset));
+
+        u32 size = block_size(offset);
+
+        // Try to merge on the left
+        if (is_previous_free(offset)) {
+            u32 previous_size = *reinterpret_cast<u32*>(m_heap.data() + offset - sizeof(u32));
+            u32 previous = offset - previous_size;
+
+            VERIFY(is_free(previous));
+            remove_free_block(previous);
+
+            offset = previous;
+            size += previous_size;
+        }
+
+        // Try to merge on the right
+        u32 next = offset + size;
+        if (is_free(next)) {
+            remove_free_block(next);
+            size += block_size(next);
+        }
+
+        // Since neighbouring free blocks are always merged, the previous block can not be free at this point.
+        block(offset).m_size_and_flags = 0;
+        set_block_size(offset, size);
+        set_free(offset, true);
+
+        insert_free_block(offset);
+    }
+
+    void MemoryAllocator::shrink_used_block(u32 offset, u32 size)
+    {
+        VERIFY(!is_free(offset));
+        VERIFY(block_size(offset) >= size);
+
+        u32 remaining_size = block_size(offset) - size;
+
+        if (remaining_size < minimum_block_size)
+            return;
+
+        set_block_size(offset, size);
+
+        // The tail becomes a used block of its own, which is then freed normally.
+        // This will merge it with the next block, if that is free.
+        u32 remainder = offset + size;
+        block(remainder).m_size_and_flags = 0;
+        set_block_size(remainder, remaining_size);
+
+        free_block(remainder);
+    }
+
+    bool MemoryAllocator::expand_used_block(u32 offset, u32 size)
+    {
+        VERIFY(!is_free(offset));
+
+        if (block_size(offset) < size) {
+            u32 next = offset + block_size(offset);
+
+            if (!is_free(next) || block_size(offset) + block_size(next) < size)
+                return false;
+
+            remove_free_block(next);
+
+            set_block_size(offset, block_size(offset) + block_size(next));
+            set_previous_free(offset + block_size(offset), false);
+        }
+
+        shrink_used_block(offset, size);
+        return true;
     }
 }
@@ -1,9 +1,50 @@
 #pragma once
 
 #include <Std/Span.hpp>
+#include <Std/MemoryTrace.hpp>
 
 namespace Std
 {
+    // A ring of trace records, if it is full, the oldest records are overwritten.
+    class MemoryTraceBuffer {
+    public:
+        MemoryTraceBuffer() = default;
+
+        explicit MemoryTraceBuffer(Span<MemoryTraceRecord> records)
+            : m_records(records)
+        {
+        }
+
+        bool is_enabled() const { return !m_records.is_empty(); }
+
+        usize size() const { return m_size; }
+        usize overwritten() const { return m_overwritten; }
+
+        void append(const MemoryTraceRecord& record);
+
+        // Moves the oldest records into 'output', returns how many records were moved.
+        usize drain(Span<MemoryTraceRecord> output);
+
+    private:
+        Span<MemoryTraceRecord> m_records;
+
+        usize m_oldest = 0;
+        usize m_size = 0;
+        usize m_overwritten = 0;
+    };
+
+    // This is a two-level segregated fit (TLSF) allocator.
+    //
+    // Free blocks are kept in segregated lists: the first level splits sizes into powers of two and the second
+    // level splits each power of two into linear ranges.  Two bitmaps remember which lists are not empty, this
+    // makes it possible to find a suitable block and to merge with neighbours in constant time.
+    //
+    // Every block starts with a header word that encodes the size of the block and two flags.  Free blocks
+    // additionally store the links of their free list and end with a footer that repeats the size.  The footer
+    // is used to find the previous block when merging.
+    //
+    // Blocks are identified by their offset into the heap, this way the layout is the same on the host and on
+    // the target.
     class MemoryAllocator {
     public:
         explicit MemoryAllocator(Bytes heap);
@@ -14,54 +55,135 @@ namespace Std
         virtual void deallocate(u8*, bool debug_override = true, void *address = nullptr);
         virtual u8* reallocate(u8*, usize, bool debug_override = true, void *address = nullptr);
 
-        void dump()
-        {
-            dbgln("m_freelist:");
-            for (auto *entry = m_freelist; entry; entry = entry->m_next)
-                dbgln("  {} ({} bytes)", entry, entry->m_size);
-
-            auto stats = statistics();
+        // Tries to resize an allocation without moving it, this fails if the next block is not free or too small.
+        // It is traced like a 'reallocate' that returns the same pointer.
+        virtual bool try_expand(u8*, usize, bool debug_override = true, void *address = nullptr);
 
-            dbgln("statistics:");
-            dbgln("  m_largest_continous_block {}", stats.m_largest_continous_block);
-            dbgln("  m_avaliable_memory        {}", stats.m_avaliable_memory);
-        }
+        void dump();
 
         struct Statistics {
             usize m_largest_continous_block;
             usize m_avaliable_memory;
         };
 
-        Statistics statistics()
-        {
-            Statistics stats;
+        Statistics statistics();
 
-            stats.m_largest_continous_block = 0;
-            stats.m_avaliable_memory = 0;
+        bool m_debug = false;
 
-            for (auto *entry = m_freelist; entry; entry = entry->m_next) {
-                stats.m_avaliable_memory += entry->m_size;
+        // Every operation is recorded in this buffer, this is much cheaper than printing MTRACE messages.
+        void set_trace_buffer(Span<MemoryTraceRecord> records) { m_trace_buffer = MemoryTraceBuffer { records }; }
+        MemoryTraceBuffer& trace_buffer() { return m_trace_buffer; }
 
-                if (entry->m_size > stats.m_largest_continous_block)
-                    stats.m_largest_continous_block = entry->m_size;
-            }
+        // Prints and removes the records in the trace buffer, 'Tools/MemoryTraceDecoder' turns them back into MTRACE messages.
+        virtual void dump_trace();
 
-            return stats;
-        }
+        static void dump_trace_record(const MemoryTraceRecord&);
 
-        bool m_debug = false;
+        struct CallSite {
+            // Zero if this entry is not used.
+            uptr m_caller;
 
-    protected:
-        struct Node {
-            usize m_size;
-            Node *m_next;
-            u8 m_data[];
+            usize m_live_bytes;
+            usize m_live_allocations;
+            usize m_peak_bytes;
+            usize m_allocations;
         };
-        static_assert(sizeof(Node) % 4 == 0);
 
+        // Accounts every allocation to the function that made it, the size of the table must be a power of two.
+        // Allocations that were made before this was enabled or after the table filled up are not accounted.
+        // This can only be enabled once.
+        void set_call_site_table(Span<CallSite> call_sites);
+        Span<CallSite> call_sites() { return m_call_sites; }
+        usize unaccounted_allocations() const { return m_unaccounted_allocations; }
+
+        virtual void dump_call_sites();
+
+        static void dump_call_site(const CallSite&);
+
+    protected:
         Bytes m_heap;
 
+        virtual u32 trace_timestamp() { return 0; }
+
     private:
-        Node *m_freelist;
+        static constexpr u32 block_header_size = 4;
+        static constexpr u32 minimum_block_size = 16;
+
+        static constexpr u32 second_level_power = 3;
+        static constexpr u32 second_level_count = 1 << second_level_power;
+
+        // Blocks smaller than this size are all put into the first list of the first level.
+        static constexpr u32 first_level_shift = second_level_power + 2;
+        static constexpr u32 small_block_size = 1 << first_level_shift;
+
+        static constexpr u32 maximum_heap_power = 20;
+        static constexpr u32 first_level_count = maximum_heap_power - first_level_shift + 1;
+
+        static constexpr u32 null_block = 0xffffffff;
+
+        static constexpr u32 block_is_free = 1 << 0;
+        static constexpr u32 previous_block_is_free = 1 << 1;
+        static constexpr u32 block_flags = block_is_free | previous_block_is_free;
+
+        // Since the heap is limited in size, the upper bits of the header are not needed for the size.
+        // In used blocks, they store the index of the call site plus one.
+        static constexpr u32 block_size_mask = ((1 << maximum_heap_power) - 1) & ~block_flags;
+        static constexpr u32 call_site_shift = maximum_heap_power;
+        static constexpr u32 maximum_call_sites = (1 << (32 - maximum_heap_power)) - 1;
+
+        // The free list links and the footer are only valid if the block is free.
+        struct Block {
+            u32 m_size_and_flags;
+            u32 m_next_free;
+            u32 m_previous_free;
+        };
+        static_assert(sizeof(Block) + sizeof(u32) <= minimum_block_size);
+
+        u32 m_first_level_bitmap = 0;
+        u32 m_second_level_bitmaps[first_level_count];
+        u32 m_free_lists[first_level_count][second_level_count];
+
+        MemoryTraceBuffer m_trace_buffer;
+
+        Span<CallSite> m_call_sites;
+        usize m_unaccounted_allocations = 0;
+
+        void trace(MemoryTraceOperation operation, void *caller, void *pointer, usize size = 0);
+
+        Block& block(u32 offset) { return *reinterpret_cast<Block*>(m_heap.data() + offset); }
+        u32& footer(u32 offset) { return *reinterpret_cast<u32*>(m_heap.data() + offset + block_size(offset) - sizeof(u32)); }
+
+        u32 block_size(u32 offset) { return block(offset).m_size_and_flags & block_size_mask; }
+        u32 call_site_index(u32 offset) { return block(offset).m_size_and_flags >> call_site_shift; }
+        bool is_free(u32 offset) { return block(offset).m_size_and_flags & block_is_free; }
+        bool is_previous_free(u32 offset) { return block(offset).m_size_and_flags & previous_block_is_free; }
+
+        void set_block_size(u32 offset, u32 size);
+        void set_free(u32 offset, bool free);
+        void set_previous_free(u32 offset, bool free);
+
+        u8* payload(u32 offset) { return m_heap.data() + offset + block_header_size; }
+        u32 offset_from_payload(u8 *pointer);
+        u32 usable_size(u32 offset) { return block_size(offset) - block_header_size; }
+
+        static u32 adjust_request_size(usize size);
+        static void mapping_insert(u32 size, u32& first_level, u32& second_level);
+        static bool mapping_search(u32 size, u32& first_level, u32& second_level);
+
+        u32 find_suitable_block(u32 first_level, u32 second_level);
+
+        void insert_free_block(u32 offset);
+        void remove_free_block(u32 offset);
+
+        void split_free_block(u32 offset, u32 size);
+
+        u32 find_call_site(void *caller);
+        void account_allocation(u32 offset, void *caller);
+        void account_deallocation(u32 offset);
+        void account_resize(u32 offset, u32 old_usable_size);
+
+        void free_block(u32 offset);
+        void shrink_used_block(u32 offset, u32 size);
+        bool expand_used_block(u32 offset, u32 size);
     };
 }
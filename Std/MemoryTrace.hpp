@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Std/Types.hpp>
+
+// This header is shared with the host tools, thus it must not depend on anything else.
+
+namespace Std
+{
+    // The operation is the character that is used in the MTRACE text.
+    enum class MemoryTraceOperation : u32 {
+        Allocate = '+',
+        Deallocate = '-',
+        ReallocateFrom = '<',
+        ReallocateTo = '>',
+    };
+
+    // This is written into the trace buffer of 'MemoryAllocator' instead of formatting a message.
+    // All fields are 32 bit wide, on the host, pointers are truncated.
+    struct MemoryTraceRecord {
+        u32 m_timestamp;
+        MemoryTraceOperation m_operation;
+        u32 m_caller;
+        u32 m_pointer;
+        u32 m_size;
+    };
+    static_assert(sizeof(MemoryTraceRecord) == 20);
+
+    // Records are dumped as lines of hexadecimal bytes with this prefix, this can be decoded by 'Tools/MemoryTraceDecoder'.
+    constexpr const char *memory_trace_dump_prefix = "MTRACE-RECORD: ";
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <Std/Forward.hpp>
+
+namespace Std
+{
+    // Hands out objects of a single type that are carved from pages of '2^PagePower' bytes.
+    //
+    // Free objects are kept in an intrusive list, thus allocating and deallocating takes constant time and does
+    // not fragment the heap.  Pages are never returned, the pool grows to the peak number of objects.
+    //
+    // This is meant to be used by class-level 'operator new' and 'operator delete'.  Objects of derived classes
+    // have a different size, these are passed on to the global allocator.
+    template<typename T, usize PagePower = 10>
+    class ObjectPool {
+    public:
+        struct Statistics {
+            usize m_live_objects;
+            usize m_peak_objects;
+            usize m_free_objects;
+            usize m_page_count;
+            usize m_allocations;
+        };
+
+        constexpr ObjectPool() = default;
+
+        ObjectPool(const ObjectPool&) = delete;
+        ObjectPool(ObjectPool&&) = delete;
+
+        void* allocate(usize size)
+        {
+            if (size != sizeof(T))
+                return ::operator new(size);
+
+            {
+                CriticalSection guard;
+
+                if (void *object = try_allocate_locked())
+                    return object;
+            }
+
+            // Getting a new page may block, thus we can not do this in the critical section.
+            u8 *page = allocate_object_pool_page(PagePower);
+
+            CriticalSection guard;
+            add_page_locked(page);
+
+            void *object = try_allocate_locked();
+            VERIFY(object != nullptr);
+            return object;
+        }
+
+        void deallocate(void *pointer, usize size)
+        {
+            if (pointer == nullptr)
+                return;
+
+            if (size != sizeof(T)) {
+                ::operator delete(pointer);
+                return;
+            }
+
+            CriticalSection guard;
+
+            auto *object = reinterpret_cast<FreeObject*>(pointer);
+            object->m_next = m_free_list;
+            m_free_list = object;
+
+            VERIFY(m_live_objects > 0);
+            --m_live_objects;
+        }
+
+        Statistics statistics() const
+        {
+            CriticalSection guard;
+
+            Statistics stats;
+            stats.m_live_objects = m_live_objects;
+            stats.m_peak_objects = m_peak_objects;
+            stats.m_free_objects = m_page_count * objects_per_page() - m_live_objects;
+            stats.m_page_count = m_page_count;
+            stats.m_allocations = m_allocations;
+
+            return stats;
+        }
+
+        static constexpr usize objects_per_page()
+        {
+            return ((1 << PagePower) - first_object_offset()) / object_size();
+        }
+
+    private:
+        struct FreeObject {
+            FreeObject *m_next;
+        };
+
+        // Pages are linked together, this way they remain reachable even if all objects are in use.
+        struct Page {
+            Page *m_next;
+        };
+
+        class CriticalSection {
+        public:
+            CriticalSection()
+            {
+                m_were_interrupts_enabled = enter_object_pool_critical_section();
+            }
+            ~CriticalSection()
+            {
+                leave_object_pool_critical_section(m_were_interrupts_enabled);
+            }
+
+        private:
+            bool m_were_interrupts_enabled;
+        };
+
+        static constexpr usize round_to_alignment(usize size)
+        {
+            return (size + object_alignment() - 1) / object_alignment() * object_alignment();
+        }
+        static constexpr usize object_alignment()
+        {
+            return max(alignof(T), alignof(FreeObject));
+        }
+        static constexpr usize object_size()
+        {
+            return round_to_alignment(max(sizeof(T), sizeof(FreeObject)));
+        }
+        static constexpr usize first_object_offset()
+        {
+            return round_to_alignment(sizeof(Page));
+        }
+
+        FreeObject *m_free_list = nullptr;
+        Page *m_pages = nullptr;
+
+        // Objects are carved from the newest page on demand, it is not necessary to put them into the free list first.
+        u8 *m_page_cursor = nullptr;
+        u8 *m_page_end = nullptr;
+
+        usize m_live_objects = 0;
+        usize m_peak_objects = 0;
+        usize m_page_count = 0;
+        usize m_allocations = 0;
+
+        void* try_allocate_locked()
+        {
+            void *object;
+
+            if (m_free_list != nullptr) {
+                object = m_free_list;
+                m_free_list = m_free_list->m_next;
+            } else if (m_page_cursor + object_size() <= m_page_end) {
+                object = m_page_cursor;
+                m_page_cursor += object_size();
+            } else {
+                return nullptr;
+            }
+
+            ++m_allocations;
+            ++m_live_objects;
+            m_peak_objects = max(m_peak_objects, m_live_objects);
+
+            return object;
+        }
+
+        void add_page_locked(u8 *page)
+        {
+            static_assert(objects_per_page() >= 1);
+            VERIFY(uptr(page) % object_alignment() == 0);
+
+            // The remaining objects of the previous page are not lost, they are put into the free list.
+            while (m_page_cursor + object_size() <= m_page_end) {
+                auto *object = reinterpret_cast<FreeObject*>(m_page_cursor);
+                object->m_next = m_free_list;
+                m_free_list = object;
+
+                m_page_cursor += object_size();
+            }
+
+            auto *new_page = reinterpret_cast<Page*>(page);
+            new_page->m_next = m_pages;
+            m_pages = new_page;
+            ++m_page_count;
+
+            m_page_cursor = page + first_object_offset();
+            m_page_end = page + (1 << PagePower);
+        }
+    };
+
+    // Classes inherit from this to allocate their objects from a pool, e.g. 'class Thread : public PoolAllocated<Thread>'.
+    template<typename T>
+    class PoolAllocated {
+    public:
+        static ObjectPool<T>& object_pool()
+        {
+            static ObjectPool<T> pool;
+            return pool;
+        }
+
+        static void* operator new(usize size) { return object_pool().allocate(size); }
+        static void operator delete(void *pointer, usize size) { object_pool().deallocate(pointer, size); }
+    };
+}
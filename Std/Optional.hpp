@@ -1,35 +1,67 @@
 #pragma once
 
 #include <Std/Forward.hpp>
+#include <Std/Concepts.hpp>
 
 #ifdef TEST
 # include <new>
 #endif
 
 namespace Std {
+    // Types with an unused bit pattern can store the empty state of 'Optional' in the value itself, instead of a
+    // separate flag that is padded to the alignment of the value.  A specialization must define 'is_defined',
+    // 'set_empty' and 'is_empty', the latter two operate on the raw storage, there is no object while it is empty.
+    template<typename T>
+    struct OptionalNiche {
+        static constexpr bool is_defined = false;
+    };
+
+    // For types that are represented by a single pointer, no object can be located at the last address.
+    struct PointerNiche {
+        static constexpr bool is_defined = true;
+        static constexpr uptr sentinel = static_cast<uptr>(-1);
+
+        static void set_empty(u8 *storage)
+        {
+            __builtin_memcpy(storage, &sentinel, sizeof(sentinel));
+        }
+        static bool is_empty(const u8 *storage)
+        {
+            uptr value;
+            __builtin_memcpy(&value, storage, sizeof(value));
+            return value == sentinel;
+        }
+    };
+
+    template<typename T>
+    struct OptionalNiche<T*> : PointerNiche {
+    };
+
     template<typename T>
     class Optional {
     public:
         Optional()
         {
-            m_is_valid = false;
+            set_empty();
         }
         Optional(const T& value)
         {
             new (m_value) T { value };
-            m_is_valid = true;
+            set_valid();
         }
         Optional(T&& value)
         {
             new (m_value) T { move(value) };
-            m_is_valid = true;
+            set_valid();
         }
         Optional(const Optional& other)
         {
+            set_empty();
             *this = other;
         }
         Optional(Optional&& other)
         {
+            set_empty();
             *this = move(other);
         }
         ~Optional()
@@ -37,7 +69,13 @@ namespace Std {
             clear();
         }
 
-        bool is_valid() const { return m_is_valid; }
+        bool is_valid() const
+        {
+            if constexpr (has_niche)
+                return !Niche::is_empty(m_value);
+            else
+                return m_flag.m_is_valid;
+        }
 
         const T& value() const & { return *reinterpret_cast<const T*>(m_value); }
         T& value() & { return *reinterpret_cast<T*>(m_value); }
@@ -72,9 +110,9 @@ namespace Std {
 
         void clear()
         {
-            if (m_is_valid) {
-                m_is_valid = false;
+            if (is_valid()) {
                 value().~T();
+                set_empty();
             }
         }
 
@@ -82,8 +120,8 @@ namespace Std {
         {
             clear();
 
-            m_is_valid = true;
             new (m_value) T { other };
+            set_valid();
 
             return *this;
         }
@@ -91,8 +129,8 @@ namespace Std {
         {
             clear();
 
-            m_is_valid = true;
             new (m_value) T { move(other) };
+            set_valid();
 
             return *this;
         }
@@ -102,8 +140,8 @@ namespace Std {
             clear();
 
             if (other.is_valid()) {
-                m_is_valid = true;
                 new (m_value) T { other.value() };
+                set_valid();
             }
 
             return *this;
@@ -113,8 +151,8 @@ namespace Std {
             clear();
 
             if (other.is_valid()) {
-                m_is_valid = true;
                 new (m_value) T { move(other.value()) };
+                set_valid();
                 other.clear();
             }
 
@@ -124,8 +162,33 @@ namespace Std {
         T* operator->() { return &must(); }
 
     private:
+        using Niche = OptionalNiche<T>;
+        static constexpr bool has_niche = Niche::is_defined;
+
+        struct Flag {
+            bool m_is_valid;
+        };
+        struct NoFlag {
+        };
+
+        // With a niche, constructing the value is enough to make it valid.
+        void set_valid()
+        {
+            if constexpr (!has_niche)
+                m_flag.m_is_valid = true;
+        }
+        void set_empty()
+        {
+            if constexpr (has_niche)
+                Niche::set_empty(m_value);
+            else
+                m_flag.m_is_valid = false;
+        }
+
         alignas(alignof(T))
         u8 m_value[sizeof(T)];
-        bool m_is_valid = false;
+
+        [[no_unique_address]]
+        typename Conditional<has_niche, NoFlag, Flag>::Type m_flag;
     };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Std/Forward.hpp>
+#include <Std/Optional.hpp>
 
 namespace Std
 {
@@ -135,6 +136,15 @@ namespace Std
         T *m_pointer;
     };
 
+    template<typename T>
+    struct OptionalNiche<NonnullOwnPtr<T>> : PointerNiche {
+        static_assert(sizeof(NonnullOwnPtr<T>) == sizeof(T*));
+    };
+    template<typename T>
+    struct OptionalNiche<OwnPtr<T>> : PointerNiche {
+        static_assert(sizeof(OwnPtr<T>) == sizeof(T*));
+    };
+
     template<typename T, typename... Parameters>
     NonnullOwnPtr<T> make(Parameters&&... parameters)
     {
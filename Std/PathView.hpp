@@ -0,0 +1,229 @@
+#pragma once
+
+#include <Std/StringView.hpp>
+
+namespace Std
+{
+    // Non-owning view of a path, the components are computed lazily from the underlying string.
+    //
+    // Empty components and '.' are skipped and '..' removes the previous component, thus the components are always
+    // normalized.  If there is nothing left to remove, absolute paths stay at the root and relative paths start with
+    // '..' components.  Nothing is allocated.
+    class PathView {
+    public:
+        PathView() = default;
+
+        PathView(StringView path)
+            : m_path(path)
+        {
+        }
+        PathView(const char *path)
+            : PathView(StringView { path })
+        {
+        }
+
+        bool is_absolute() const { return m_path.starts_with('/'); }
+        StringView string() const { return m_path; }
+
+        class Iterator {
+        public:
+            Iterator(StringView path, usize limit)
+                : m_path(path)
+                , m_remaining(limit)
+            {
+                advance();
+            }
+
+            Iterator begin() { return *this; }
+            Iterator end()
+            {
+                Iterator end;
+                end.m_done = true;
+                return end;
+            }
+
+            StringView operator*() const { return m_current; }
+
+            Iterator& operator++()
+            {
+                advance();
+                return *this;
+            }
+
+            bool operator==(const Iterator& other) const
+            {
+                return m_done == other.m_done && (m_done || m_current.data() == other.m_current.data());
+            }
+            bool operator!=(const Iterator& other) const
+            {
+                return !operator==(other);
+            }
+
+        private:
+            Iterator() = default;
+
+            // Returns the next component that is not empty and not '.', or an empty view at the end.
+            static StringView next_raw(StringView path, usize& offset)
+            {
+                while (offset < path.size()) {
+                    usize start = offset;
+                    while (offset < path.size() && path.data()[offset] != '/')
+                        ++offset;
+
+                    StringView component { path.data() + start, offset - start };
+
+                    if (offset < path.size())
+                        ++offset;
+
+                    if (component.size() == 0 || component == ".")
+                        continue;
+
+                    return component;
+                }
+
+                return {};
+            }
+
+            // A component is removed if it is followed by a '..' that is not used up by the components in between.
+            bool is_removed_later(usize offset) const
+            {
+                usize depth = 0;
+                for (;;) {
+                    StringView component = next_raw(m_path, offset);
+
+                    if (component.size() == 0)
+                        return false;
+
+                    if (component != "..")
+                        ++depth;
+                    else if (depth == 0)
+                        return true;
+                    else
+                        --depth;
+                }
+            }
+
+            void advance()
+            {
+                while (m_remaining > 0) {
+                    StringView component = next_raw(m_path, m_offset);
+
+                    if (component.size() == 0)
+                        break;
+
+                    if (component == "..") {
+                        // This '..' belongs to a component that was already skipped.
+                        if (m_skipped > 0) {
+                            --m_skipped;
+                            continue;
+                        }
+
+                        // The parent of the root directory is the root directory itself.
+                        if (m_path.starts_with('/'))
+                            continue;
+                    } else if (is_removed_later(m_offset)) {
+                        ++m_skipped;
+                        continue;
+                    }
+
+                    m_current = component;
+                    --m_remaining;
+                    return;
+                }
+
+                m_done = true;
+                m_current = {};
+            }
+
+            StringView m_path;
+            usize m_offset = 0;
+            usize m_skipped = 0;
+            usize m_remaining = 0;
+
+            StringView m_current;
+            bool m_done = false;
+        };
+
+        Iterator components() const { return Iterator { m_path, m_limit }; }
+
+        usize component_count() const
+        {
+            usize count = 0;
+            for (StringView component : components()) {
+                (void)component;
+                ++count;
+            }
+            return count;
+        }
+
+        // The path without the last component, this refers to the same string.
+        PathView parent() const
+        {
+            usize count = component_count();
+            VERIFY(count >= 1);
+
+            PathView parent = *this;
+            parent.m_limit = count - 1;
+            return parent;
+        }
+
+        StringView filename() const
+        {
+            StringView filename;
+            for (StringView component : components())
+                filename = component;
+
+            VERIFY(filename.size() >= 1);
+            return filename;
+        }
+
+        // Calls 'callback' with each component of 'path' resolved relative to 'base', which must be absolute.
+        // The result is always absolute, '..' at the start of 'path' removes components of 'base'.
+        template<typename Callback>
+        static IterationDecision for_each_resolved_component(PathView base, PathView path, Callback&& callback)
+        {
+            VERIFY(base.is_absolute());
+
+            if (path.is_absolute()) {
+                for (StringView component : path.components()) {
+                    if (callback(component) == IterationDecision::Break)
+                        return IterationDecision::Break;
+                }
+                return IterationDecision::Continue;
+            }
+
+            usize leading_parents = 0;
+            for (StringView component : path.components()) {
+                if (component != "..")
+                    break;
+                ++leading_parents;
+            }
+
+            usize base_count = base.component_count();
+            PathView kept_base = base;
+            kept_base.m_limit = base_count - min(base_count, leading_parents);
+
+            for (StringView component : kept_base.components()) {
+                if (callback(component) == IterationDecision::Break)
+                    return IterationDecision::Break;
+            }
+
+            usize index = 0;
+            for (StringView component : path.components()) {
+                if (index++ < leading_parents)
+                    continue;
+
+                if (callback(component) == IterationDecision::Break)
+                    return IterationDecision::Break;
+            }
+
+            return IterationDecision::Continue;
+        }
+
+    private:
+        StringView m_path;
+
+        // Used by 'parent', only this many components are visited.
+        usize m_limit = static_cast<usize>(-1);
+    };
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Std/Forward.hpp>
+#include <Std/Concepts.hpp>
+#include <Std/Optional.hpp>
 
 namespace Std
 {
@@ -93,6 +95,18 @@ namespace Std
             return *m_pointer;
         }
 
+        // Releases the reference without dropping it, it must be taken over again with 'adopt_ref' later.
+        T* leak_ref()
+        {
+            return exchange(m_pointer, nullptr);
+        }
+        static RefPtr adopt_ref(T& object)
+        {
+            RefPtr pointer;
+            pointer.m_pointer = &object;
+            return pointer;
+        }
+
         operator const T*() const { return m_pointer; }
         operator T*() { return m_pointer; }
 
@@ -148,4 +162,13 @@ namespace Std
     private:
         usize m_refcount = 1;
     };
+
+    template<typename T>
+    struct IsTriviallyRelocatable<RefPtr<T>> : IntegralConstant<bool, true> {
+    };
+
+    template<typename T>
+    struct OptionalNiche<RefPtr<T>> : PointerNiche {
+        static_assert(sizeof(RefPtr<T>) == sizeof(T*));
+    };
 }
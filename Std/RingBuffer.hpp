@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Std/Forward.hpp>
+#include <Std/Concepts.hpp>
+#include <Std/Optional.hpp>
+#include <Std/Span.hpp>
+
+namespace Std
+{
+    // Lock-free queue with a fixed capacity for exactly one producer and one consumer, e.g. an interrupt handler
+    // and a thread.  Neither side has to disable interrupts.
+    //
+    // The offsets are free running and only ever written by one side: the producer publishes elements by storing
+    // 'm_tail' with release semantics after writing them, the consumer releases slots by storing 'm_head' after
+    // reading them.  On the RP2040 these are plain 32-bit loads and stores with 'dmb' barriers, no exclusive
+    // access instructions are required.
+    template<Concepts::TriviallyCopyable T, usize Size>
+    class RingBuffer {
+        static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "Size must be a power of two");
+
+    public:
+        RingBuffer() = default;
+
+        RingBuffer(const RingBuffer&) = delete;
+        RingBuffer& operator=(const RingBuffer&) = delete;
+
+        // Must only be called by the producer.
+        bool try_push(const T& value)
+        {
+            return push_n(Span<const T> { &value, 1 }) == 1;
+        }
+
+        // Must only be called by the producer, returns how many elements were pushed.
+        usize push_n(Span<const T> values)
+        {
+            u32 tail = __atomic_load_n(&m_tail, __ATOMIC_RELAXED);
+            u32 head = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+
+            usize count = min<usize>(values.size(), Size - (tail - head));
+            for (usize index = 0; index < count; ++index)
+                m_data[(tail + index) % Size] = values.data()[index];
+
+            __atomic_store_n(&m_tail, tail + count, __ATOMIC_RELEASE);
+            return count;
+        }
+
+        // Must only be called by the consumer.
+        Optional<T> try_pop()
+        {
+            T value;
+            if (pop_n(Span<T> { &value, 1 }) == 1)
+                return value;
+            return {};
+        }
+
+        // Must only be called by the consumer, returns how many elements were popped.
+        usize pop_n(Span<T> values)
+        {
+            u32 head = __atomic_load_n(&m_head, __ATOMIC_RELAXED);
+            u32 tail = __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+
+            usize count = min<usize>(values.size(), tail - head);
+            for (usize index = 0; index < count; ++index)
+                values.data()[index] = m_data[(head + index) % Size];
+
+            __atomic_store_n(&m_head, head + count, __ATOMIC_RELEASE);
+            return count;
+        }
+
+        // This is only a snapshot if called concurrently with the other side.
+        usize size() const
+        {
+            // Load 'm_head' first, it can not overtake the 'm_tail' that is loaded afterwards.
+            u32 head = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+            u32 tail = __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+            return tail - head;
+        }
+        bool is_empty() const { return size() == 0; }
+
+        usize capacity() const { return Size; }
+        usize avaliable() const { return capacity() - size(); }
+
+    private:
+        u32 m_head = 0;
+        u32 m_tail = 0;
+
+        T m_data[Size];
+    };
+}
@@ -2,11 +2,13 @@
 
 #include <Std/Forward.hpp>
 #include <Std/StringBuilder.hpp>
+#include <Std/ObjectPool.hpp>
 
 namespace Std
 {
-    // FIXME: Upgrade to red/black trees
-
+    // Red/black tree, all operations are O(log n).  Apart from 'dump', only building from a sorted range recurses, its
+    // depth is the height of the balanced result, O(log n), thus this can be used with large sets on the small kernel
+    // stacks.
     template<typename T>
     class SortedSet {
     public:
@@ -31,13 +33,14 @@ namespace Std
             *this = move(other);
         }
 
-        struct Node {
+        struct Node : PoolAllocated<Node> {
             Node(const T& value)
                 : m_value(value)
             {
                 m_left = nullptr;
                 m_right = nullptr;
                 m_parent = nullptr;
+                m_red = true;
             }
             Node(T&& value)
                 : m_value(move(value))
@@ -45,14 +48,10 @@ namespace Std
                 m_left = nullptr;
                 m_right = nullptr;
                 m_parent = nullptr;
-            }
-            ~Node()
-            {
-                delete m_left;
-                delete m_right;
+                m_red = true;
             }
 
-            void dump(StringBuilder& builder) const
+            void dump(FormatSink& builder) const
             {
                 if (m_left == nullptr && m_right == nullptr) {
                     builder.appendf("{}", m_value);
@@ -76,43 +75,25 @@ namespace Std
                 builder.append(')');
             }
 
-            void replace_child(Node *old, Node *new_)
-            {
-                if (m_left == old) {
-                    if (m_left != nullptr)
-                        m_left->m_parent = nullptr;
-
-                    m_left = new_;
-                    if (m_left)
-                        m_left->m_parent = this;
-                } else if (m_right == old) {
-                    if (m_right != nullptr)
-                        m_right->m_parent = nullptr;
-
-                    m_right = new_;
-                    if (m_right)
-                        m_right->m_parent = this;
-                } else {
-                    ASSERT_NOT_REACHED();
-                }
-            }
-
             T m_value;
             Node *m_left;
             Node *m_right;
             Node *m_parent;
+            bool m_red;
         };
 
+        // Iterates from the current node up to, but not including, the end node.
         class InorderIterator {
         public:
-            InorderIterator(SortedSet& set, Node *root)
+            InorderIterator(SortedSet& set, Node *current, Node *end = nullptr)
                 : m_set(set)
-                , m_current(root)
+                , m_current(current)
+                , m_end(end)
             {
             }
 
             InorderIterator begin() { return *this; }
-            InorderIterator end() { return { m_set, nullptr }; }
+            InorderIterator end() { return { m_set, m_end, m_end }; }
 
             bool is_end() { return *this == end(); }
 
@@ -123,22 +104,7 @@ namespace Std
             {
                 ASSERT(m_current);
 
-                if (m_current->m_right != nullptr) {
-                    Node *parent = nullptr;
-                    m_current = m_set.min_impl(m_current->m_right, &parent);
-
-                    return *this;
-                }
-
-                while (m_current->m_parent && m_current->m_parent->m_left != m_current)
-                    m_current = m_current->m_parent;
-
-                if (m_current->m_parent == nullptr) {
-                    m_current = nullptr;
-                    return *this;
-                }
-
-                m_current = m_current->m_parent;
+                m_current = SortedSet::successor(m_current);
                 return *this;
             }
             InorderIterator operator++(int)
@@ -148,11 +114,11 @@ namespace Std
                 return copy;
             }
 
-            bool operator==(InorderIterator& other) const
+            bool operator==(const InorderIterator& other) const
             {
                 return m_current == other.m_current;
             }
-            bool operator!=(InorderIterator& other) const
+            bool operator!=(const InorderIterator& other) const
             {
                 return !operator==(other);
             }
@@ -160,12 +126,30 @@ namespace Std
         private:
             SortedSet& m_set;
             Node *m_current;
+            Node *m_end;
         };
 
+        // Builds a balanced tree in O(n), the values must be sorted and unique.
+        static SortedSet from_sorted(Span<const T> values)
+        {
+            for (usize index = 1; index < values.size(); ++index)
+                ASSERT(values[index - 1] < values[index]);
+
+            // Every level is filled completely, except the last one which is colored red.
+            usize full_levels = 0;
+            while ((usize(2) << full_levels) - 1 <= values.size())
+                ++full_levels;
+
+            SortedSet set;
+            set.m_root = set.build_from_sorted(values, 0, full_levels);
+            set.m_size = values.size();
+
+            return set;
+        }
+
         T* search(const T& value)
         {
-            Node *parent = nullptr;
-            Node *node = search_impl(value, &parent, m_root);
+            Node *node = search_impl(value);
 
             if (node != nullptr)
                 return &node->m_value;
@@ -173,7 +157,7 @@ namespace Std
                 return nullptr;
         }
 
-        void dump(StringBuilder& builder) const
+        void dump(FormatSink& builder) const
         {
             if (m_root)
                 m_root->dump(builder);
@@ -196,8 +180,7 @@ namespace Std
         }
         T* min()
         {
-            Node *parent = nullptr;
-            Node *node = min_impl(m_root, &parent);
+            Node *node = min_impl(m_root);
 
             if (node)
                 return &node->m_value;
@@ -207,42 +190,103 @@ namespace Std
 
         void remove(const T& value)
         {
-            Node *parent = nullptr;
-            Node *node = search_impl(value, &parent, m_root);
-
-            if (node == nullptr)
-                return;
+            Node *node = search_impl(value);
 
-            if (node->m_left == nullptr || node->m_right == nullptr)
-                return remove_impl(node, parent);
+            if (node != nullptr)
+                remove_impl(node);
+        }
 
-            Node *min_in_right_parent = node;
-            Node *min_in_right = min_impl(node->m_right, &min_in_right_parent);
-            ASSERT(min_in_right);
+        InorderIterator inorder()
+        {
+            return InorderIterator { *this, min_impl(m_root) };
+        }
 
-            node->m_value = move(min_in_right->m_value);
+        // The first value that is not smaller than the given value.
+        InorderIterator lower_bound(const T& value)
+        {
+            return InorderIterator { *this, lower_bound_impl(value) };
+        }
 
-            remove_impl(min_in_right, min_in_right_parent);
+        // The first value that is larger than the given value.
+        InorderIterator upper_bound(const T& value)
+        {
+            return InorderIterator { *this, upper_bound_impl(value) };
         }
 
-        InorderIterator inorder()
+        // All values that are not smaller than 'lower' and smaller than 'upper'.
+        InorderIterator range(const T& lower, const T& upper)
         {
-            Node *parent = nullptr;
-            Node *min = min_impl(m_root, &parent);
+            if (!(lower < upper))
+                return InorderIterator { *this, nullptr };
 
-            return InorderIterator { *this, min };
+            return InorderIterator { *this, lower_bound_impl(lower), lower_bound_impl(upper) };
         }
 
         usize size() const { return m_size; }
 
         void clear()
         {
-            delete m_root;
+            // Delete the leaves one by one, this avoids recursion.
+            Node *node = m_root;
+            while (node != nullptr) {
+                if (node->m_left != nullptr) {
+                    node = node->m_left;
+                } else if (node->m_right != nullptr) {
+                    node = node->m_right;
+                } else {
+                    Node *parent = node->m_parent;
+
+                    if (parent != nullptr && parent->m_left == node)
+                        parent->m_left = nullptr;
+                    else if (parent != nullptr)
+                        parent->m_right = nullptr;
+
+                    delete node;
+                    node = parent;
+                }
+            }
 
             m_root = nullptr;
             m_size = 0;
         }
 
+        // Verifies the red/black properties and returns the number of black nodes on each path.
+        usize verify_invariants() const
+        {
+            VERIFY(m_root == nullptr || (!m_root->m_red && m_root->m_parent == nullptr));
+
+            usize black_height = 0;
+            for (Node *node = m_root; node != nullptr; node = node->m_left)
+                black_height += !node->m_red;
+
+            usize count = 0;
+            for (Node *node = min_impl(m_root); node != nullptr; node = successor(node)) {
+                ++count;
+
+                if (node->m_left != nullptr)
+                    VERIFY(node->m_left->m_parent == node && node->m_left->m_value < node->m_value);
+                if (node->m_right != nullptr)
+                    VERIFY(node->m_right->m_parent == node && node->m_right->m_value > node->m_value);
+
+                if (node->m_red) {
+                    VERIFY(node->m_left == nullptr || !node->m_left->m_red);
+                    VERIFY(node->m_right == nullptr || !node->m_right->m_red);
+                }
+
+                // Every path that ends here must have the same number of black nodes.
+                if (node->m_left == nullptr || node->m_right == nullptr) {
+                    usize path_black_height = 0;
+                    for (Node *ancestor = node; ancestor != nullptr; ancestor = ancestor->m_parent)
+                        path_black_height += !ancestor->m_red;
+
+                    VERIFY(path_black_height == black_height);
+                }
+            }
+            VERIFY(count == m_size);
+
+            return black_height;
+        }
+
         SortedSet& operator=(SortedSet&& other)
         {
             clear();
@@ -254,96 +298,341 @@ namespace Std
         }
 
     private:
+        static bool is_red(Node *node)
+        {
+            return node != nullptr && node->m_red;
+        }
+
+        Node* build_from_sorted(Span<const T> values, usize depth, usize full_levels)
+        {
+            if (values.size() == 0)
+                return nullptr;
+
+            usize middle = values.size() / 2;
+
+            Node *node = new Node { values[middle] };
+            node->m_red = depth >= full_levels;
+
+            node->m_left = build_from_sorted({ values.data(), middle }, depth + 1, full_levels);
+            node->m_right = build_from_sorted(values.slice(middle + 1), depth + 1, full_levels);
+
+            if (node->m_left)
+                node->m_left->m_parent = node;
+            if (node->m_right)
+                node->m_right->m_parent = node;
+
+            return node;
+        }
+
         template<typename T_>
         T& insert_impl(T_&& value)
         {
             Node *parent = nullptr;
-            Node *node = search_impl(value, &parent, m_root);
+            Node *node = m_root;
+
+            while (node != nullptr) {
+                if (value < node->m_value) {
+                    parent = node;
+                    node = node->m_left;
+                } else if (value > node->m_value) {
+                    parent = node;
+                    node = node->m_right;
+                } else {
+                    node->m_value = forward<T_>(value);
+                    return node->m_value;
+                }
+            }
+
+            node = new Node { forward<T_>(value) };
+            node->m_parent = parent;
+
+            if (parent == nullptr)
+                m_root = node;
+            else if (node->m_value < parent->m_value)
+                parent->m_left = node;
+            else
+                parent->m_right = node;
 
-            if (node) {
-                node->m_value = forward<T_>(value);
+            ++m_size;
+
+            fix_after_insert(node);
+            return node->m_value;
+        }
+
+        void fix_after_insert(Node *node)
+        {
+            while (is_red(node->m_parent)) {
+                Node *parent = node->m_parent;
+                Node *grandparent = parent->m_parent;
 
-                return node->m_value;
-            } else if (parent == nullptr) {
-                node = m_root = new Node { forward<T_>(value) };
-                ++m_size;
+                // The root is black, thus a red parent always has a parent.
+                ASSERT(grandparent != nullptr);
 
-                return node->m_value;
-            } else if (value < parent->m_value) {
-                ASSERT(parent->m_left == nullptr);
-                node = parent->m_left = new Node { forward<T_>(value) };
-                node->m_parent = parent;
-                ++m_size;
+                bool parent_is_left = grandparent->m_left == parent;
+                Node *uncle = parent_is_left ? grandparent->m_right : grandparent->m_left;
 
-                return node->m_value;
+                if (is_red(uncle)) {
+                    parent->m_red = false;
+                    uncle->m_red = false;
+                    grandparent->m_red = true;
+
+                    node = grandparent;
+                    continue;
+                }
+
+                if (parent_is_left) {
+                    if (node == parent->m_right) {
+                        rotate_left(parent);
+                        node = parent;
+                        parent = node->m_parent;
+                    }
+
+                    rotate_right(grandparent);
+                } else {
+                    if (node == parent->m_left) {
+                        rotate_right(parent);
+                        node = parent;
+                        parent = node->m_parent;
+                    }
+
+                    rotate_left(grandparent);
+                }
+
+                parent->m_red = false;
+                grandparent->m_red = true;
+                break;
+            }
+
+            m_root->m_red = false;
+        }
+
+        void remove_impl(Node *node)
+        {
+            // The node that is removed from its position in the tree and its replacement there.
+            // If the node has two children, it is replaced by its successor which is moved out of its own position.
+            Node *moved = node;
+            bool moved_was_red = moved->m_red;
+
+            Node *child;
+            Node *child_parent;
+
+            if (node->m_left == nullptr) {
+                child = node->m_right;
+                child_parent = node->m_parent;
+                transplant(node, node->m_right);
+            } else if (node->m_right == nullptr) {
+                child = node->m_left;
+                child_parent = node->m_parent;
+                transplant(node, node->m_left);
             } else {
-                ASSERT(value > parent->m_value);
+                moved = min_impl(node->m_right);
+                moved_was_red = moved->m_red;
+                child = moved->m_right;
 
-                ASSERT(parent->m_right == nullptr);
-                node = parent->m_right = new Node { forward<T_>(value) };
-                node->m_parent = parent;
-                ++m_size;
+                if (moved->m_parent == node) {
+                    child_parent = moved;
+                } else {
+                    child_parent = moved->m_parent;
+                    transplant(moved, moved->m_right);
 
-                return node->m_value;
+                    moved->m_right = node->m_right;
+                    moved->m_right->m_parent = moved;
+                }
+
+                transplant(node, moved);
+
+                moved->m_left = node->m_left;
+                moved->m_left->m_parent = moved;
+                moved->m_red = node->m_red;
             }
+
+            delete node;
+            --m_size;
+
+            if (!moved_was_red)
+                fix_after_remove(child, child_parent);
         }
 
-        Node* search_impl(const T& value, Node **parent, Node *subtree)
+        // The subtree of 'node' is missing one black node, 'node' may be null.
+        void fix_after_remove(Node *node, Node *parent)
         {
-            if (subtree == nullptr)
-                return nullptr;
+            while (node != m_root && !is_red(node)) {
+                if (node == parent->m_left) {
+                    Node *sibling = parent->m_right;
+
+                    if (is_red(sibling)) {
+                        sibling->m_red = false;
+                        parent->m_red = true;
+                        rotate_left(parent);
+                        sibling = parent->m_right;
+                    }
+
+                    if (!is_red(sibling->m_left) && !is_red(sibling->m_right)) {
+                        sibling->m_red = true;
+                        node = parent;
+                        parent = node->m_parent;
+                        continue;
+                    }
+
+                    if (!is_red(sibling->m_right)) {
+                        sibling->m_left->m_red = false;
+                        sibling->m_red = true;
+                        rotate_right(sibling);
+                        sibling = parent->m_right;
+                    }
+
+                    sibling->m_red = parent->m_red;
+                    parent->m_red = false;
+                    sibling->m_right->m_red = false;
+                    rotate_left(parent);
+                } else {
+                    Node *sibling = parent->m_left;
+
+                    if (is_red(sibling)) {
+                        sibling->m_red = false;
+                        parent->m_red = true;
+                        rotate_right(parent);
+                        sibling = parent->m_left;
+                    }
+
+                    if (!is_red(sibling->m_left) && !is_red(sibling->m_right)) {
+                        sibling->m_red = true;
+                        node = parent;
+                        parent = node->m_parent;
+                        continue;
+                    }
+
+                    if (!is_red(sibling->m_left)) {
+                        sibling->m_right->m_red = false;
+                        sibling->m_red = true;
+                        rotate_left(sibling);
+                        sibling = parent->m_left;
+                    }
+
+                    sibling->m_red = parent->m_red;
+                    parent->m_red = false;
+                    sibling->m_left->m_red = false;
+                    rotate_right(parent);
+                }
 
-            if (value < subtree->m_value) {
-                *parent = subtree;
-                return search_impl(value, parent, subtree->m_left);
-            } else if (value > subtree->m_value) {
-                *parent = subtree;
-                return search_impl(value, parent, subtree->m_right);
-            } else {
-                return subtree;
+                node = m_root;
+                break;
             }
+
+            if (node != nullptr)
+                node->m_red = false;
         }
 
-        Node* min_impl(Node* subtree, Node **parent)
+        // Replaces the subtree of 'old' with the subtree of 'new_' in the parent of 'old'.
+        void transplant(Node *old, Node *new_)
         {
-            if (subtree == nullptr)
-                return nullptr;
+            if (old->m_parent == nullptr)
+                m_root = new_;
+            else if (old->m_parent->m_left == old)
+                old->m_parent->m_left = new_;
+            else
+                old->m_parent->m_right = new_;
 
-            if (subtree->m_left == nullptr)
-                return subtree;
+            if (new_ != nullptr)
+                new_->m_parent = old->m_parent;
+        }
 
-            *parent = subtree;
-            return min_impl(subtree->m_left, parent);
+        void rotate_left(Node *node)
+        {
+            Node *right = node->m_right;
+
+            node->m_right = right->m_left;
+            if (right->m_left != nullptr)
+                right->m_left->m_parent = node;
+
+            transplant(node, right);
+
+            right->m_left = node;
+            node->m_parent = right;
         }
 
-        void remove_impl(Node *node, Node *parent)
+        void rotate_right(Node *node)
         {
-            ASSERT(node->m_left == nullptr || node->m_right == nullptr);
+            Node *left = node->m_left;
 
-            if (node->m_left == nullptr && node->m_right == nullptr) {
-                if (parent)
-                    parent->replace_child(node, nullptr);
-                else
-                    m_root = nullptr;
-            } else if (node->m_left == nullptr) {
-                if (parent)
-                    parent->replace_child(node, node->m_right);
-                else
-                    m_root = node->m_right;
+            node->m_left = left->m_right;
+            if (left->m_right != nullptr)
+                left->m_right->m_parent = node;
 
-                node->m_right = nullptr;
-            } else {
-                if (parent)
-                    parent->replace_child(node, node->m_left);
+            transplant(node, left);
+
+            left->m_right = node;
+            node->m_parent = left;
+        }
+
+        Node* search_impl(const T& value)
+        {
+            Node *node = m_root;
+
+            while (node != nullptr) {
+                if (value < node->m_value)
+                    node = node->m_left;
+                else if (value > node->m_value)
+                    node = node->m_right;
                 else
-                    m_root = node->m_left;
+                    return node;
+            }
+
+            return nullptr;
+        }
+
+        Node* lower_bound_impl(const T& value)
+        {
+            Node *result = nullptr;
 
-                node->m_left = nullptr;
+            for (Node *node = m_root; node != nullptr; ) {
+                if (node->m_value < value) {
+                    node = node->m_right;
+                } else {
+                    result = node;
+                    node = node->m_left;
+                }
             }
 
-            node->m_parent = nullptr;
-            delete node;
-            --m_size;
+            return result;
+        }
+
+        Node* upper_bound_impl(const T& value)
+        {
+            Node *result = nullptr;
+
+            for (Node *node = m_root; node != nullptr; ) {
+                if (node->m_value > value) {
+                    result = node;
+                    node = node->m_left;
+                } else {
+                    node = node->m_right;
+                }
+            }
+
+            return result;
+        }
+
+        static Node* min_impl(Node *subtree)
+        {
+            if (subtree == nullptr)
+                return nullptr;
+
+            while (subtree->m_left != nullptr)
+                subtree = subtree->m_left;
+
+            return subtree;
+        }
+
+        static Node* successor(Node *node)
+        {
+            if (node->m_right != nullptr)
+                return min_impl(node->m_right);
+
+            while (node->m_parent && node->m_parent->m_left != node)
+                node = node->m_parent;
+
+            return node->m_parent;
         }
 
         Node *m_root;
@@ -352,7 +641,7 @@ namespace Std
 
     template<typename T>
     struct Formatter<SortedSet<T>> {
-        static void format(StringBuilder& builder, const SortedSet<T>& value)
+        static void format(FormatSink& builder, const SortedSet<T>& value)
         {
             return value.dump(builder);
         }
@@ -4,6 +4,150 @@
 #include <Std/Concepts.hpp>
 
 namespace Std {
+    // Bulk operations on bytes that process a machine word at a time.
+    //
+    // Words are only accessed at aligned addresses, the RP2040 faults on unaligned loads and stores.  The bytes in
+    // front of the first aligned word and after the last one are processed one by one.  If two buffers can not be
+    // aligned at the same time, everything is processed byte by byte.
+    using BulkWord __attribute__((__may_alias__)) = usize;
+
+    inline bool is_word_aligned(const void *pointer)
+    {
+        return (reinterpret_cast<usize>(pointer) & (sizeof(BulkWord) - 1)) == 0;
+    }
+
+    // Returns how many bytes must be processed one by one, before 'pointer' is aligned.
+    inline usize bytes_until_word_aligned(const void *pointer, usize count)
+    {
+        usize misalignment = reinterpret_cast<usize>(pointer) & (sizeof(BulkWord) - 1);
+        return min(count, misalignment == 0 ? 0 : sizeof(BulkWord) - misalignment);
+    }
+
+    inline bool have_same_word_alignment(const void *a, const void *b)
+    {
+        return ((reinterpret_cast<usize>(a) ^ reinterpret_cast<usize>(b)) & (sizeof(BulkWord) - 1)) == 0;
+    }
+
+    // Sets every byte of the word to 'value'.
+    inline BulkWord broadcast_byte(u8 value)
+    {
+        return (~BulkWord(0) / 0xff) * value;
+    }
+
+    // Sets the high bit of every byte that is zero and clears all other bits.  Unlike the shorter '(x - 0x01..) & ~x &
+    // 0x80..' this has no false positives, thus the masks of different patterns can be combined.
+    inline BulkWord zero_byte_mask(BulkWord word)
+    {
+        BulkWord low_bits = broadcast_byte(0x7f);
+        return ~(((word & low_bits) + low_bits) | word | low_bits);
+    }
+
+    // Returns the index of the first byte in memory order with the high bit set, the mask must not be zero.
+    inline usize first_marked_byte(BulkWord mask)
+    {
+        static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__);
+        return __builtin_ctzl(mask) / 8;
+    }
+
+    // The buffers must not overlap.
+    inline void copy_bytes(void *destination_, const void *source_, usize count)
+    {
+        u8 *destination = reinterpret_cast<u8*>(destination_);
+        const u8 *source = reinterpret_cast<const u8*>(source_);
+
+        if (have_same_word_alignment(destination, source)) {
+            for (usize head = bytes_until_word_aligned(source, count); head > 0; --head, --count)
+                *destination++ = *source++;
+
+            for (; count >= sizeof(BulkWord); count -= sizeof(BulkWord)) {
+                *reinterpret_cast<BulkWord*>(destination) = *reinterpret_cast<const BulkWord*>(source);
+                destination += sizeof(BulkWord);
+                source += sizeof(BulkWord);
+            }
+        }
+
+        for (; count > 0; --count)
+            *destination++ = *source++;
+    }
+
+    inline void fill_bytes(void *destination_, u8 value, usize count)
+    {
+        u8 *destination = reinterpret_cast<u8*>(destination_);
+
+        for (usize head = bytes_until_word_aligned(destination, count); head > 0; --head, --count)
+            *destination++ = value;
+
+        BulkWord word = broadcast_byte(value);
+        for (; count >= sizeof(BulkWord); count -= sizeof(BulkWord)) {
+            *reinterpret_cast<BulkWord*>(destination) = word;
+            destination += sizeof(BulkWord);
+        }
+
+        for (; count > 0; --count)
+            *destination++ = value;
+    }
+
+    // Compares like 'memcmp', the result is negative, zero or positive.
+    inline int compare_bytes(const void *a_, const void *b_, usize count)
+    {
+        const u8 *a = reinterpret_cast<const u8*>(a_);
+        const u8 *b = reinterpret_cast<const u8*>(b_);
+
+        if (have_same_word_alignment(a, b)) {
+            for (usize head = bytes_until_word_aligned(a, count); head > 0; --head, --count) {
+                if (*a != *b)
+                    return *a - *b;
+                ++a;
+                ++b;
+            }
+
+            // The word that differs is compared byte by byte below, this finds the first differing byte.
+            while (count >= sizeof(BulkWord) && *reinterpret_cast<const BulkWord*>(a) == *reinterpret_cast<const BulkWord*>(b)) {
+                a += sizeof(BulkWord);
+                b += sizeof(BulkWord);
+                count -= sizeof(BulkWord);
+            }
+        }
+
+        for (; count > 0; --count) {
+            if (*a != *b)
+                return *a - *b;
+            ++a;
+            ++b;
+        }
+
+        return 0;
+    }
+
+    // Returns the offset of the first byte that equals 'value' or 'count' if there is none.
+    inline usize find_byte(const void *data_, u8 value, usize count)
+    {
+        const u8 *data = reinterpret_cast<const u8*>(data_);
+        usize offset = 0;
+
+        for (usize head = bytes_until_word_aligned(data, count); offset < head; ++offset) {
+            if (data[offset] == value)
+                return offset;
+        }
+
+        // After the xor, the matching bytes are zero.
+        BulkWord pattern = broadcast_byte(value);
+
+        for (; offset + sizeof(BulkWord) <= count; offset += sizeof(BulkWord)) {
+            BulkWord matches = zero_byte_mask(*reinterpret_cast<const BulkWord*>(data + offset) ^ pattern);
+
+            if (matches != 0)
+                return offset + first_marked_byte(matches);
+        }
+
+        for (; offset < count; ++offset) {
+            if (data[offset] == value)
+                return offset;
+        }
+
+        return count;
+    }
+
     template<typename T>
     class SpanIterator;
 
@@ -41,8 +185,12 @@ namespace Std {
         {
             VERIFY(other.size() >= size());
 
-            for (usize index = 0; index < size(); ++index)
-                other[index] = (*this)[index];
+            if constexpr (Concepts::TriviallyCopyable<T>) {
+                copy_bytes(other.data(), data(), size() * sizeof(T));
+            } else {
+                for (usize index = 0; index < size(); ++index)
+                    other[index] = (*this)[index];
+            }
 
             return other.size();
         }
@@ -51,10 +199,20 @@ namespace Std {
         {
             usize count = min(size(), other.size());
 
-            memcpy(other.data(), data(), count);
+            copy_bytes(other.data(), data(), count * sizeof(T));
             return count;
         }
 
+        void fill(const T& value)
+        {
+            if constexpr (sizeof(T) == 1 && Concepts::TriviallyCopyable<T>) {
+                fill_bytes(data(), *reinterpret_cast<const u8*>(&value), size());
+            } else {
+                for (usize index = 0; index < size(); ++index)
+                    (*this)[index] = value;
+            }
+        }
+
         Span<const T> slice(usize offset) const
         {
             VERIFY(offset <= size());
@@ -25,14 +25,14 @@ public:
     {
     }
 
-    Optional<usize> index_of(char ch)
+    Optional<usize> index_of(char ch) const
     {
-        char *pointer = __builtin_strchr(data(), ch);
+        usize index = find_byte(data(), static_cast<u8>(ch), size());
 
-        if (pointer == nullptr)
+        if (index == size())
             return {};
 
-        return pointer - data();
+        return index;
     }
 
     StringView substr(usize index)
@@ -57,7 +57,7 @@ public:
     {
         VERIFY(other.size() >= size() + 1);
 
-        __builtin_memcpy(other.data(), data(), size());
+        copy_bytes(other.data(), data(), size());
         other.data()[size()] = 0;
     }
 
@@ -74,7 +74,7 @@ public:
         if (size() > rhs.size())
             return std::strong_ordering::greater;
 
-        int retval = __builtin_memcmp(data(), rhs.data(), size());
+        int retval = compare_bytes(data(), rhs.data(), size());
 
         if (retval < 0) {
             return std::strong_ordering::less;
@@ -87,11 +87,53 @@ public:
 
     bool operator==(StringView rhs) const
     {
-        return operator<=>(rhs) == std::strong_ordering::equal;
+        return size() == rhs.size() && compare_bytes(data(), rhs.data(), size()) == 0;
     }
 
     ReadonlyBytes bytes() const { return { reinterpret_cast<const u8*>(data()), size() }; }
 
+    // MurmurHash3 (x86, 32-bit), https://github.com/aappleby/smhasher
+    //
+    // Four bytes are mixed at a time, the result does not depend on the alignment of the data.
+    u32 hash() const
+    {
+        using AliasingU32 __attribute__((__may_alias__)) = u32;
+
+        auto rotate_left = [](u32 value, u32 count) { return (value << count) | (value >> (32 - count)); };
+        auto scramble = [&](u32 value) { return rotate_left(value * 0xcc9e2d51, 15) * 0x1b873593; };
+
+        const u8 *data = reinterpret_cast<const u8*>(this->data());
+        usize count = size();
+        u32 hash = 0;
+
+        for (; count >= 4; count -= 4, data += 4) {
+            u32 value;
+            if ((reinterpret_cast<usize>(data) & 3) == 0)
+                value = *reinterpret_cast<const AliasingU32*>(data);
+            else
+                value = u32(data[0]) | u32(data[1]) << 8 | u32(data[2]) << 16 | u32(data[3]) << 24;
+
+            hash ^= scramble(value);
+            hash = rotate_left(hash, 13) * 5 + 0xe6546b64;
+        }
+
+        u32 tail = 0;
+        for (usize index = 0; index < count; ++index)
+            tail |= u32(data[index]) << (index * 8);
+        if (count > 0)
+            hash ^= scramble(tail);
+
+        hash ^= static_cast<u32>(size());
+
+        hash ^= hash >> 16;
+        hash *= 0x85ebca6b;
+        hash ^= hash >> 13;
+        hash *= 0xc2b2ae35;
+        hash ^= hash >> 16;
+
+        return hash;
+    }
+
 private:
     void copy_to(Span<char> other) const;
 };
@@ -55,43 +55,95 @@ namespace Std
             return *pointer;
         }
 
+        template<typename... Parameters>
+        T& emplace(Parameters&&... parameters)
+        {
+            ensure_capacity(m_size + 1);
+
+            T *pointer = new (data() + m_size) T { forward<Parameters>(parameters)... };
+            ++m_size;
+
+            return *pointer;
+        }
+
         void extend(Span<const T> values)
         {
             ensure_capacity(m_size + values.size());
 
-            for (auto& value : values.iter())
-                append(value);
+            if constexpr (Concepts::TriviallyCopyable<T>) {
+                memcpy(static_cast<void*>(data() + m_size), values.data(), values.size() * sizeof(T));
+            } else {
+                for (usize index = 0; index < values.size(); ++index)
+                    new (data() + m_size + index) T { values[index] };
+            }
+
+            m_size += values.size();
         }
 
+        T& insert(usize index, const T& value)
+        {
+            return insert_impl(index, value);
+        }
+        T& insert(usize index, T&& value)
+        {
+            return insert_impl(index, move(value));
+        }
+
+        void remove(usize index)
+        {
+            VERIFY(index < m_size);
+
+            data()[index].~T();
+
+            if constexpr (Concepts::TriviallyRelocatable<T>) {
+                memmove(static_cast<void*>(data() + index), static_cast<void*>(data() + index + 1), (m_size - index - 1) * sizeof(T));
+            } else {
+                for (usize current = index; current + 1 < m_size; ++current) {
+                    new (data() + current) T { move(data()[current + 1]) };
+                    data()[current + 1].~T();
+                }
+            }
+
+            --m_size;
+        }
+
+        // Grows the capacity to the next power of two.
         void ensure_capacity(usize new_capacity)
         {
             if (m_capacity >= new_capacity)
                 return;
 
-            new_capacity = round_to_power_of_two(new_capacity);
+            reallocate(round_to_power_of_two(new_capacity));
+        }
 
-            T *new_data = reinterpret_cast<T*>(new u8[sizeof(T) * new_capacity]);
-            ASSERT(new_data != nullptr);
+        // Grows the capacity to exactly this size.
+        void reserve(usize new_capacity)
+        {
+            if (m_capacity >= new_capacity)
+                return;
 
-            ASSERT(new_capacity > m_size);
+            reallocate(new_capacity);
+        }
 
-            if constexpr (Concepts::Primitive<T>) {
-                memcpy(new_data, data(), m_size * sizeof(T));
-            } else {
-                // Otherwise, we will get misaligned read/write problems here
-                ASSERT(sizeof(T) % 4 == 0);
+        // Releases the unused capacity, the elements are moved back into the inline buffer if they fit.
+        void shrink_to_fit()
+        {
+            if (m_use_inline_data || m_capacity == m_size)
+                return;
 
-                for (usize i = 0; i < m_size; ++ i) {
-                    new (new_data + i) T { move(data()[i]) };
-                    data()[i].~T();
-                }
-            }
+            if (m_size <= InlineSize) {
+                T *old_data = m_data;
 
-            operator delete[](m_data);
+                relocate(reinterpret_cast<T*>(m_inline_data), old_data, m_size);
+                operator delete[](old_data);
 
-            m_data = new_data;
-            m_capacity = new_capacity;
-            m_use_inline_data = false;
+                m_use_inline_data = true;
+                m_capacity = InlineSize;
+                m_data = nullptr;
+                return;
+            }
+
+            reallocate(m_size);
         }
 
         const T* data() const
@@ -162,7 +214,70 @@ namespace Std
         usize m_size;
         usize m_capacity;
 
-        u8 m_inline_data[sizeof(T) * InlineSize];
+        alignas(T) u8 m_inline_data[sizeof(T) * InlineSize];
         T *m_data;
+
+        // Moves the elements into uninitialized memory, the source is left uninitialized.
+        static void relocate(T *destination, T *source, usize count)
+        {
+            if constexpr (Concepts::TriviallyRelocatable<T>) {
+                memcpy(static_cast<void*>(destination), static_cast<void*>(source), count * sizeof(T));
+            } else {
+                for (usize index = 0; index < count; ++index) {
+                    new (destination + index) T { move(source[index]) };
+                    source[index].~T();
+                }
+            }
+        }
+
+        void reallocate(usize new_capacity)
+        {
+            ASSERT(new_capacity >= m_size);
+
+            // If the allocator can resize the buffer in place, we do not have to move anything.
+            if (!m_use_inline_data && m_data != nullptr && try_expand_allocation(m_data, sizeof(T) * new_capacity)) {
+                m_capacity = new_capacity;
+                return;
+            }
+
+            T *new_data = reinterpret_cast<T*>(new u8[sizeof(T) * new_capacity]);
+            ASSERT(new_data != nullptr);
+
+            relocate(new_data, data(), m_size);
+
+            operator delete[](m_data);
+
+            m_data = new_data;
+            m_capacity = new_capacity;
+            m_use_inline_data = false;
+        }
+
+        template<typename T_>
+        T& insert_impl(usize index, T_&& value)
+        {
+            VERIFY(index <= m_size);
+
+            if (index == m_size)
+                return append(forward<T_>(value));
+
+            // The value could be an element of this vector.
+            T copy { forward<T_>(value) };
+
+            ensure_capacity(m_size + 1);
+
+            if constexpr (Concepts::TriviallyRelocatable<T>) {
+                memmove(static_cast<void*>(data() + index + 1), static_cast<void*>(data() + index), (m_size - index) * sizeof(T));
+            } else {
+                for (usize current = m_size; current > index; --current) {
+                    new (data() + current) T { move(data()[current - 1]) };
+                    data()[current - 1].~T();
+                }
+            }
+
+            T *pointer = new (data() + index) T { move(copy) };
+            ++m_size;
+
+            return *pointer;
+        }
     };
 }
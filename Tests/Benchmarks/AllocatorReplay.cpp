@@ -0,0 +1,339 @@
+// Replays MTRACE sequences against the allocator engines and compares them.
+//
+// The trace is taken from a captured console log with 'MemoryAllocator::m_debug' enabled.  Records that were
+// dumped in binary form need to be converted with 'Tools/MemoryTraceDecoder' first.  Without a capture, a
+// synthetic workload is used.
+//
+//     AllocatorReplay [--heap-size <bytes>] [<captured-log>]
+
+#include <Std/MemoryAllocator.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Operation {
+    enum class Type {
+        Allocate,
+        Deallocate,
+        Reallocate,
+    };
+
+    Type m_type;
+
+    // These are the addresses from the capture, they are only used to pair operations.
+    u32 m_old_pointer;
+    u32 m_new_pointer;
+    u32 m_size;
+};
+
+struct Trace {
+    std::string m_name;
+    std::vector<Operation> m_operations;
+};
+
+class Engine {
+public:
+    virtual ~Engine() = default;
+
+    virtual const char* name() const = 0;
+
+    virtual u8* allocate(usize size) = 0;
+    virtual void deallocate(u8 *pointer) = 0;
+    virtual u8* reallocate(u8 *pointer, usize size) = 0;
+
+    // Returns the bytes that are in use and the free bytes, if the engine knows this.
+    virtual std::optional<std::pair<usize, usize>> usage() = 0;
+    virtual std::optional<usize> largest_free_block() = 0;
+};
+
+class TLSFEngine final : public Engine {
+public:
+    explicit TLSFEngine(usize heap_size)
+        : m_heap(heap_size)
+        , m_allocator(Std::Bytes { m_heap.data(), m_heap.size() })
+    {
+    }
+
+    const char* name() const override { return "Std::MemoryAllocator"; }
+
+    u8* allocate(usize size) override { return m_allocator.allocate(size, false); }
+    void deallocate(u8 *pointer) override { m_allocator.deallocate(pointer, false); }
+    u8* reallocate(u8 *pointer, usize size) override { return m_allocator.reallocate(pointer, size, false); }
+
+    std::optional<std::pair<usize, usize>> usage() override
+    {
+        auto stats = m_allocator.statistics();
+        return std::pair { m_allocator.heap_size() - stats.m_avaliable_memory, stats.m_avaliable_memory };
+    }
+    std::optional<usize> largest_free_block() override
+    {
+        return m_allocator.statistics().m_largest_continous_block;
+    }
+
+private:
+    std::vector<u8> m_heap;
+    Std::MemoryAllocator m_allocator;
+};
+
+// The allocator of the host system, this is only useful as a reference for the throughput.
+class SystemEngine final : public Engine {
+public:
+    const char* name() const override { return "malloc (host)"; }
+
+    u8* allocate(usize size) override { return reinterpret_cast<u8*>(std::malloc(size)); }
+    void deallocate(u8 *pointer) override { std::free(pointer); }
+    u8* reallocate(u8 *pointer, usize size) override { return reinterpret_cast<u8*>(std::realloc(pointer, size)); }
+
+    std::optional<std::pair<usize, usize>> usage() override { return {}; }
+    std::optional<usize> largest_free_block() override { return {}; }
+};
+
+static std::optional<Trace> parse_capture(const char *path)
+{
+    std::ifstream input { path };
+    if (!input)
+        return {};
+
+    Trace trace;
+    trace.m_name = path;
+
+    // A reallocation is printed as two messages, '<' and '>'.
+    std::optional<u32> reallocate_from;
+
+    std::string line;
+    while (std::getline(input, line)) {
+        size_t offset = line.find("MTRACE: @ ");
+        if (offset == std::string::npos)
+            continue;
+
+        std::istringstream stream { line.substr(offset + 10) };
+
+        std::string caller, type, pointer, size;
+        stream >> caller >> type >> pointer >> size;
+
+        u32 pointer_value = std::strtoul(pointer.c_str(), nullptr, 16);
+        u32 size_value = std::strtoul(size.c_str(), nullptr, 16);
+
+        if (type == "+") {
+            trace.m_operations.push_back({ Operation::Type::Allocate, 0, pointer_value, size_value });
+        } else if (type == "-") {
+            trace.m_operations.push_back({ Operation::Type::Deallocate, pointer_value, 0, 0 });
+        } else if (type == "<") {
+            reallocate_from = pointer_value;
+        } else if (type == ">" && reallocate_from.has_value()) {
+            trace.m_operations.push_back({ Operation::Type::Reallocate, *reallocate_from, pointer_value, size_value });
+            reallocate_from.reset();
+        }
+    }
+
+    return trace;
+}
+
+// Roughly what the shell does when it spawns processes: short strings, growing vectors and some larger buffers.
+static Trace generate_synthetic_trace(usize operation_count)
+{
+    Trace trace;
+    trace.m_name = "synthetic";
+
+    std::mt19937 prng { 1361245623 };
+
+    std::vector<std::pair<u32, u32>> live;
+    u32 next_pointer = 0x20000000;
+    usize live_bytes = 0;
+
+    while (trace.m_operations.size() < operation_count) {
+        u32 choice = prng() % 16;
+
+        if (live.size() > 0 && (choice < 6 || live_bytes > 8 * KiB)) {
+            usize index = prng() % live.size();
+            trace.m_operations.push_back({ Operation::Type::Deallocate, live[index].first, 0, 0 });
+
+            live_bytes -= live[index].second;
+            live.erase(live.begin() + index);
+        } else if (live.size() > 0 && choice < 9) {
+            usize index = prng() % live.size();
+            u32 size = live[index].second * 2;
+
+            if (size > 1 * KiB)
+                continue;
+
+            trace.m_operations.push_back({ Operation::Type::Reallocate, live[index].first, next_pointer, size });
+
+            live_bytes += size - live[index].second;
+            live[index] = { next_pointer, size };
+            next_pointer += 0x1000;
+        } else {
+            u32 size = choice < 15 ? 4 + prng() % 60 : 256 + prng() % 768;
+            trace.m_operations.push_back({ Operation::Type::Allocate, 0, next_pointer, size });
+
+            live_bytes += size;
+            live.push_back({ next_pointer, size });
+            next_pointer += 0x1000;
+        }
+    }
+
+    return trace;
+}
+
+struct Result {
+    usize m_operations = 0;
+    usize m_skipped = 0;
+    std::chrono::nanoseconds m_total_time { 0 };
+    std::chrono::nanoseconds m_worst_time { 0 };
+
+    std::optional<usize> m_peak_usage;
+    std::optional<double> m_worst_fragmentation;
+    std::optional<double> m_final_fragmentation;
+};
+
+// How much of the free memory can not be used for a single allocation.
+static std::optional<double> fragmentation(Engine& engine)
+{
+    auto usage = engine.usage();
+    auto largest = engine.largest_free_block();
+
+    if (!usage.has_value() || !largest.has_value() || usage->second == 0)
+        return {};
+
+    return 1.0 - double(*largest) / double(usage->second);
+}
+
+static Result replay(Engine& engine, const Trace& trace)
+{
+    Result result;
+    std::map<u32, u8*> pointers;
+
+    auto timed = [&](auto&& callback) {
+        auto start = std::chrono::steady_clock::now();
+        callback();
+        auto duration = std::chrono::steady_clock::now() - start;
+
+        result.m_total_time += duration;
+        result.m_worst_time = std::max<std::chrono::nanoseconds>(result.m_worst_time, duration);
+        ++result.m_operations;
+    };
+
+    for (auto& operation : trace.m_operations) {
+        switch (operation.m_type) {
+        case Operation::Type::Allocate: {
+            u8 *pointer;
+            timed([&] { pointer = engine.allocate(operation.m_size); });
+            pointers[operation.m_new_pointer] = pointer;
+            break;
+        }
+        case Operation::Type::Deallocate: {
+            // The capture may have started after this was allocated.
+            auto iterator = pointers.find(operation.m_old_pointer);
+            if (iterator == pointers.end()) {
+                ++result.m_skipped;
+                continue;
+            }
+
+            timed([&] { engine.deallocate(iterator->second); });
+            pointers.erase(iterator);
+            break;
+        }
+        case Operation::Type::Reallocate: {
+            u8 *old_pointer = nullptr;
+
+            auto iterator = pointers.find(operation.m_old_pointer);
+            if (iterator != pointers.end()) {
+                old_pointer = iterator->second;
+                pointers.erase(iterator);
+            }
+
+            u8 *new_pointer;
+            timed([&] { new_pointer = engine.reallocate(old_pointer, operation.m_size); });
+            pointers[operation.m_new_pointer] = new_pointer;
+            break;
+        }
+        }
+
+        // This is not part of the measured time.
+        if (auto usage = engine.usage(); usage.has_value())
+            result.m_peak_usage = std::max(result.m_peak_usage.value_or(0), usage->first);
+
+        if (auto value = fragmentation(engine); value.has_value())
+            result.m_worst_fragmentation = std::max(result.m_worst_fragmentation.value_or(0.0), *value);
+    }
+
+    result.m_final_fragmentation = fragmentation(engine);
+
+    for (auto& [recorded_pointer, pointer] : pointers)
+        engine.deallocate(pointer);
+
+    return result;
+}
+
+static std::string format_optional(std::optional<double> value, const char *format)
+{
+    if (!value.has_value())
+        return "n/a";
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), format, *value);
+    return buffer;
+}
+
+int main(int argc, char **argv)
+{
+    usize heap_size = 0x4000;
+    const char *capture_path = nullptr;
+
+    for (int index = 1; index < argc; ++index) {
+        if (std::strcmp(argv[index], "--heap-size") == 0 && index + 1 < argc)
+            heap_size = std::strtoul(argv[++index], nullptr, 0);
+        else
+            capture_path = argv[index];
+    }
+
+    Trace trace;
+    if (capture_path != nullptr) {
+        auto trace_opt = parse_capture(capture_path);
+        if (!trace_opt.has_value()) {
+            std::cerr << "Can not open '" << capture_path << "'\n";
+            return 1;
+        }
+        trace = std::move(*trace_opt);
+    } else {
+        trace = generate_synthetic_trace(4096);
+    }
+
+    std::vector<std::unique_ptr<Engine>> engines;
+    engines.push_back(std::make_unique<TLSFEngine>(heap_size));
+    engines.push_back(std::make_unique<SystemEngine>());
+
+    std::printf("trace: %s (%zu operations), heap: %zu bytes\n\n", trace.m_name.c_str(), trace.m_operations.size(), heap_size);
+    std::printf("%-22s %12s %12s %14s %14s %12s\n", "engine", "ops/sec", "peak bytes", "worst frag.", "final frag.", "worst ns");
+
+    for (auto& engine : engines) {
+        Result result = replay(*engine, trace);
+
+        double seconds = std::chrono::duration<double>(result.m_total_time).count();
+        double operations_per_second = seconds > 0 ? result.m_operations / seconds : 0;
+
+        std::printf("%-22s %12.0f %12s %14s %14s %12lld\n",
+            engine->name(),
+            operations_per_second,
+            format_optional(result.m_peak_usage.has_value() ? std::optional<double>(*result.m_peak_usage) : std::nullopt, "%.0f").c_str(),
+            format_optional(result.m_worst_fragmentation, "%.3f").c_str(),
+            format_optional(result.m_final_fragmentation, "%.3f").c_str(),
+            static_cast<long long>(result.m_worst_time.count()));
+
+        if (result.m_skipped > 0)
+            std::printf("  skipped %zu operations on memory that was allocated before the capture started\n", result.m_skipped);
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Compares the word-at-a-time 'copy_bytes', 'fill_bytes', 'compare_bytes' and 'find_byte' with the byte by byte
+// loops they replace.  The host has no alignment restrictions, but only aligned words are used as on the RP2040.
+// The RP2040 has no vector unit, build with '-fno-tree-vectorize' to get comparable numbers.
+//
+//     BulkBenchmark [--count <iterations>]
+
+#include <Std/Span.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+// The compiler would otherwise replace these loops with calls to 'memcpy' and 'memset' or vectorize them.
+#define LEGACY_LOOP __attribute__((noinline, optimize("no-tree-loop-distribute-patterns", "no-tree-vectorize")))
+
+LEGACY_LOOP static void legacy_copy(u8 *destination, const u8 *source, usize count)
+{
+    for (usize index = 0; index < count; ++index)
+        destination[index] = source[index];
+}
+
+LEGACY_LOOP static void legacy_fill(u8 *destination, u8 value, usize count)
+{
+    for (usize index = 0; index < count; ++index)
+        destination[index] = value;
+}
+
+LEGACY_LOOP static int legacy_compare(const u8 *a, const u8 *b, usize count)
+{
+    for (usize index = 0; index < count; ++index) {
+        if (a[index] < b[index])
+            return -1;
+        if (a[index] > b[index])
+            return 1;
+    }
+    return 0;
+}
+
+LEGACY_LOOP static usize legacy_find(const u8 *data, u8 value, usize count)
+{
+    for (usize index = 0; index < count; ++index) {
+        if (data[index] == value)
+            return index;
+    }
+    return count;
+}
+
+static double measure(usize count, const std::function<void(usize)>& callback)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (usize index = 0; index < count; ++index)
+        callback(index);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+// Prevents the compiler from optimizing the result away.
+static usize checksum = 0;
+
+int main(int argc, char **argv)
+{
+    usize count = 5000;
+
+    for (int index = 1; index < argc; ++index) {
+        if (std::strcmp(argv[index], "--count") == 0 && index + 1 < argc)
+            count = std::strtoul(argv[++index], nullptr, 0);
+    }
+
+    // Large enough for a flash page, the offsets are used to test the unaligned heads and tails.
+    constexpr usize size = 4096;
+    alignas(16) static u8 source[size + 16];
+    alignas(16) static u8 destination[size + 16];
+
+    for (usize index = 0; index < sizeof(source); ++index)
+        source[index] = u8(index % 251 + 1);
+
+    std::printf("%zu iterations, nanoseconds per operation\n\n", count);
+    std::printf("%-36s %10s %10s\n", "operation", "bytewise", "words");
+
+    auto report = [](const char *name, double legacy, double bulk) {
+        std::printf("%-36s %10.1f %10.1f\n", name, legacy, bulk);
+    };
+
+    for (usize offset : { 0, 3 }) {
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "copy 4096 bytes, offset %zu", offset);
+        report(name,
+            measure(count, [&](usize) { legacy_copy(destination + offset, source + offset, size); checksum += destination[offset]; }),
+            measure(count, [&](usize) { Std::copy_bytes(destination + offset, source + offset, size); checksum += destination[offset]; }));
+
+        std::snprintf(name, sizeof(name), "fill 4096 bytes, offset %zu", offset);
+        report(name,
+            measure(count, [&](usize index) { legacy_fill(destination + offset, u8(index), size); checksum += destination[offset]; }),
+            measure(count, [&](usize index) { Std::fill_bytes(destination + offset, u8(index), size); checksum += destination[offset]; }));
+
+        Std::copy_bytes(destination, source, sizeof(source));
+
+        std::snprintf(name, sizeof(name), "compare 4096 equal bytes, offset %zu", offset);
+        report(name,
+            measure(count, [&](usize) { checksum += legacy_compare(destination + offset, source + offset, size); }),
+            measure(count, [&](usize) { checksum += Std::compare_bytes(destination + offset, source + offset, size); }));
+
+        std::snprintf(name, sizeof(name), "compare 24 byte names, offset %zu", offset);
+        report(name,
+            measure(count, [&](usize) { checksum += legacy_compare(destination + offset, source + offset, 24); }),
+            measure(count, [&](usize) { checksum += Std::compare_bytes(destination + offset, source + offset, 24); }));
+
+        std::snprintf(name, sizeof(name), "find in 4096 bytes, offset %zu", offset);
+        report(name,
+            measure(count, [&](usize) { checksum += legacy_find(source + offset, 0, size); }),
+            measure(count, [&](usize) { checksum += Std::find_byte(source + offset, 0, size); }));
+    }
+
+    std::printf("\nchecksum %zu\n", checksum);
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Compares compiled format strings with the runtime 'Std::vformat' path and with 'std::snprintf'.
+//
+//     FormatBenchmark [--count <iterations>]
+
+#include <Std/Format.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+// This is how integers were formatted before: every digit is appended to the builder on its own.
+struct LegacyInteger {
+    u32 m_value;
+};
+
+template<>
+struct Std::Formatter<LegacyInteger> {
+    static void format(Std::FormatSink& builder, LegacyInteger value)
+    {
+        builder.append("0x");
+
+        char buffer[sizeof(u32) * 2];
+        for (usize index = 0; index < sizeof(buffer); ++index) {
+            buffer[index] = "0123456789abcdef"[value.m_value % 16];
+            value.m_value /= 16;
+        }
+
+        for (usize index = 0; index < sizeof(buffer); ++index)
+            builder.append(buffer[(sizeof(buffer) - 1) - index]);
+    }
+};
+
+static double measure(usize count, const std::function<void(usize)>& callback)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (usize index = 0; index < count; ++index)
+        callback(index);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+// Prevents the compiler from optimizing the result away.
+static usize checksum = 0;
+
+int main(int argc, char **argv)
+{
+    usize count = 100000;
+
+    for (int index = 1; index < argc; ++index) {
+        if (std::strcmp(argv[index], "--count") == 0 && index + 1 < argc)
+            count = std::strtoul(argv[++index], nullptr, 0);
+    }
+
+    Std::StringView name = "Kernel: SystemHandler";
+
+    std::printf("%zu iterations, nanoseconds per message\n\n", count);
+    std::printf("%-44s %10s\n", "format", "time");
+
+    auto report = [](const char *name, double time) {
+        std::printf("%-44s %10.1f\n", name, time);
+    };
+
+    report("vformat, legacy integers", measure(count, [&](usize index) {
+        Std::StringBuilder builder;
+        Std::vformat(builder, "[{}] pid={} ip={} lr={}", Std::VariadicFormatParams {
+            name, LegacyInteger { u32(index) }, LegacyInteger { 0x10001234 }, LegacyInteger { 0x20004321 } });
+        checksum += builder.size();
+    }));
+
+    report("vformat", measure(count, [&](usize index) {
+        Std::StringBuilder builder;
+        Std::vformat(builder, "[{}] pid={} ip={} lr={}", Std::VariadicFormatParams {
+            name, u32(index), u32(0x10001234), u32(0x20004321) });
+        checksum += builder.size();
+    }));
+
+    report("compiled", measure(count, [&](usize index) {
+        Std::StringBuilder builder;
+        builder.appendf("[{}] pid={} ip={} lr={}", name, u32(index), u32(0x10001234), u32(0x20004321));
+        checksum += builder.size();
+    }));
+
+    report("compiled, decimal and padded hexadecimal", measure(count, [&](usize index) {
+        Std::StringBuilder builder;
+        builder.appendf("[{}] pid={:d} ip={:#010x} lr={:#010x}", name, u32(index), u32(0x10001234), u32(0x20004321));
+        checksum += builder.size();
+    }));
+
+    report("std::snprintf, decimal and padded hexadecimal", measure(count, [&](usize index) {
+        char buffer[256];
+        checksum += std::snprintf(buffer, sizeof(buffer), "[%.*s] pid=%u ip=%#010x lr=%#010x",
+            int(name.size()), name.data(), unsigned(index), 0x10001234u, 0x20004321u);
+    }));
+
+    std::printf("\nchecksum %zu\n", checksum);
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+// Compares 'Std::HashMap' with the tree it used to be built on and with 'std::unordered_map'.
+//
+//     HashTableBenchmark [--count <entries>]
+
+#include <Std/HashMap.hpp>
+#include <Std/SortedSet.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// This is how 'Std::HashTable' was implemented before: a binary tree ordered by the hash.
+template<typename Key, typename Value>
+class TreeMap {
+public:
+    void set(const Key& key, const Value& value)
+    {
+        m_set.insert({ Std::Hash<Key>::compute(key), key, value });
+    }
+    Value* get(const Key& key)
+    {
+        Node *node = m_set.search({ Std::Hash<Key>::compute(key), key, {} });
+        return node != nullptr ? &node->m_value : nullptr;
+    }
+    void remove(const Key& key)
+    {
+        m_set.remove({ Std::Hash<Key>::compute(key), key, {} });
+    }
+
+private:
+    struct Node {
+        u32 m_hash;
+        Key m_key;
+        Value m_value;
+
+        bool operator<(const Node& other) const
+        {
+            if (m_hash != other.m_hash)
+                return m_hash < other.m_hash;
+            return m_key < other.m_key;
+        }
+        bool operator>(const Node& other) const
+        {
+            if (m_hash != other.m_hash)
+                return m_hash > other.m_hash;
+            return m_key > other.m_key;
+        }
+    };
+
+    Std::SortedSet<Node> m_set;
+};
+
+template<typename Key, typename Value>
+class StandardMap {
+public:
+    void set(const Key& key, const Value& value)
+    {
+        m_map.insert_or_assign(key, value);
+    }
+    Value* get(const Key& key)
+    {
+        auto iterator = m_map.find(key);
+        return iterator != m_map.end() ? &iterator->second : nullptr;
+    }
+    void remove(const Key& key)
+    {
+        m_map.erase(key);
+    }
+
+private:
+    struct KeyHash {
+        usize operator()(const Key& key) const { return Std::Hash<Key>::compute(key); }
+    };
+
+    std::unordered_map<Key, Value, KeyHash> m_map;
+};
+
+static double measure(const std::function<void()>& callback)
+{
+    auto start = std::chrono::steady_clock::now();
+    callback();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename Map, typename Key>
+static void run(const char *name, const std::vector<Key>& keys, const std::vector<Key>& missing_keys)
+{
+    Map map;
+    usize found = 0;
+
+    double insert_time = measure([&] {
+        for (usize index = 0; index < keys.size(); ++index)
+            map.set(keys[index], index);
+    });
+
+    double hit_time = measure([&] {
+        for (auto& key : keys)
+            found += map.get(key) != nullptr;
+    });
+
+    double miss_time = measure([&] {
+        for (auto& key : missing_keys)
+            found += map.get(key) != nullptr;
+    });
+
+    double remove_time = measure([&] {
+        for (auto& key : keys)
+            map.remove(key);
+    });
+
+    if (found != keys.size()) {
+        std::printf("%s: found %zu of %zu entries\n", name, found, keys.size());
+        std::exit(1);
+    }
+
+    std::printf("%-26s %10.1f %10.1f %10.1f %10.1f\n",
+        name,
+        insert_time / keys.size(),
+        hit_time / keys.size(),
+        miss_time / missing_keys.size(),
+        remove_time / keys.size());
+}
+
+int main(int argc, char **argv)
+{
+    usize count = 4096;
+
+    for (int index = 1; index < argc; ++index) {
+        if (std::strcmp(argv[index], "--count") == 0 && index + 1 < argc)
+            count = std::strtoul(argv[++index], nullptr, 0);
+    }
+
+    std::mt19937 prng { 1361245623 };
+
+    // Sequential keys are what the file descriptor tables and the device map use.
+    std::vector<u32> integer_keys, missing_integer_keys;
+    for (usize index = 0; index < count; ++index) {
+        integer_keys.push_back(index);
+        missing_integer_keys.push_back(count + index);
+    }
+
+    // Directory entries are short names.
+    std::vector<Std::ImmutableString> string_keys, missing_string_keys;
+    for (usize index = 0; index < count; ++index) {
+        std::string name = "file" + std::to_string(index) + ".txt";
+        string_keys.push_back(Std::StringView { name.c_str(), name.size() });
+
+        name = "missing" + std::to_string(prng());
+        missing_string_keys.push_back(Std::StringView { name.c_str(), name.size() });
+    }
+
+    std::printf("%zu entries, nanoseconds per operation\n\n", count);
+    std::printf("%-26s %10s %10s %10s %10s\n", "map", "insert", "hit", "miss", "remove");
+
+    run<Std::HashMap<u32, usize>>("Std::HashMap<u32>", integer_keys, missing_integer_keys);
+    run<TreeMap<u32, usize>>("tree<u32>", integer_keys, missing_integer_keys);
+    run<StandardMap<u32, usize>>("std::unordered_map<u32>", integer_keys, missing_integer_keys);
+
+    run<Std::HashMap<Std::ImmutableString, usize>>("Std::HashMap<string>", string_keys, missing_string_keys);
+    run<TreeMap<Std::ImmutableString, usize>>("tree<string>", string_keys, missing_string_keys);
+    run<StandardMap<Std::ImmutableString, usize>>("std::unordered_map<string>", string_keys, missing_string_keys);
+
+    return 0;
+}
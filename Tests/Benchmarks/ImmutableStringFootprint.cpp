@@ -0,0 +1,197 @@
+// Estimates what storing short 'ImmutableString' values inline costs and saves on the RP2040.  The strings that the
+// kernel creates during boot and when the shell spawns a program are built with the host types, the allocations of
+// 'ImmutableStringInstance' are measured and the footprint is computed for 32-bit pointers.
+//
+// Listing a directory, e.g. 'ls /bin', is not included: the path is resolved with 'PathView' and the existing names
+// are copied out, it does not construct any strings.
+//
+//     ImmutableStringFootprint
+
+#include <Std/HashMap.hpp>
+#include <Std/Path.hpp>
+
+#include <cstdio>
+#include <vector>
+
+// 'RefCounted', the buffer pointer, the buffer size and the cached hash.
+constexpr usize instance_size = 16;
+
+// This is what 'MemoryAllocator' reserves for a buffer: a four byte header and at least 16 bytes.
+static usize heap_block_size(usize size)
+{
+    return max<usize>((size + 3) / 4 * 4 + 4, 16);
+}
+
+struct Layout {
+    const char *m_name;
+    usize m_size;
+    usize m_inline_capacity;
+    bool m_has_static;
+};
+
+static constexpr Layout layouts[] = {
+    { "4 bytes, pointer only", 4, 0, false },
+    { "8 bytes, 7 characters inline", 8, Std::ImmutableString::inline_capacity, true },
+    { "12 bytes, 11 characters inline", 12, 11, true },
+};
+
+class Census {
+public:
+    // Records a string that is constructed from characters, 'live' strings are still referenced by the kernel when
+    // the scenario is done.
+    Std::ImmutableString make(Std::ImmutableString string, bool live = true)
+    {
+        m_entries.push_back({ string.size(), string.is_static(), live });
+        return string;
+    }
+
+    // Paths that are only used to look up a file.
+    void lookup(const char *path)
+    {
+        Std::Path parsed { path };
+        for (auto& component : parsed.components())
+            m_entries.push_back({ component.size(), false, false });
+    }
+
+    // The unused slots of a hash map grow with the string as well.
+    template<typename Value>
+    void add_unused_slots(const Std::HashMap<Std::ImmutableString, Value>& map)
+    {
+        m_unused_slots += map.capacity() - map.size();
+    }
+
+    void report(const char *name, usize measured_instances)
+    {
+        std::printf("%s: %zu strings, %zu 'ImmutableStringInstance' allocations measured\n\n",
+            name, m_entries.size(), measured_instances);
+        std::printf("%-32s %12s %12s\n", "layout", "allocations", "live bytes");
+
+        for (const Layout& layout : layouts) {
+            usize allocations = 0;
+            usize bytes = m_unused_slots * layout.m_size;
+
+            for (const Entry& entry : m_entries) {
+                bool is_shared = entry.m_size > layout.m_inline_capacity && !(entry.m_is_static && layout.m_has_static);
+
+                // The instance and its buffer.
+                if (is_shared)
+                    allocations += 2;
+
+                if (!entry.m_live)
+                    continue;
+
+                bytes += layout.m_size;
+                if (is_shared)
+                    bytes += instance_size + heap_block_size(entry.m_size + 1);
+            }
+
+            std::printf("%-32s %12zu %12zu\n", layout.m_name, allocations, bytes);
+        }
+
+        std::printf("\n");
+    }
+
+private:
+    struct Entry {
+        usize m_size;
+        bool m_is_static;
+        bool m_live;
+    };
+
+    std::vector<Entry> m_entries;
+    usize m_unused_slots = 0;
+};
+
+static usize instance_allocations()
+{
+    return Std::ImmutableStringInstance::object_pool().statistics().m_allocations;
+}
+
+// Mirrors 'boot', 'boot_with_scheduler' and the file systems they initialize.
+static void boot()
+{
+    Census census;
+    usize allocations = instance_allocations();
+
+    std::vector<Std::ImmutableString> thread_names;
+    thread_names.push_back(census.make("Kernel (boot_with_scheduler)"));
+    thread_names.push_back(census.make("Kernel: Default Thread"));
+    thread_names.push_back(census.make("Kernel: Fallback Thread"));
+    census.make("Dummy", false);
+
+    // FlashFileSystem, the names of the entries are referenced in flash.
+    Std::HashMap<Std::ImmutableString, int> bin;
+    bin.set(census.make("."), 0);
+    bin.set(census.make(".."), 0);
+    for (const char *name : { "Editor.elf", "Example.elf", "Shell.elf" })
+        bin.set(census.make(Std::ImmutableString::from_static(name)), 0);
+
+    // MemoryFileSystem, the '..' entry of '/bin' is replaced.
+    Std::HashMap<Std::ImmutableString, int> root;
+    Std::HashMap<Std::ImmutableString, int> dev;
+    root.set(census.make("."), 0);
+    root.set(census.make(".."), 0);
+    dev.set(census.make(".."), 0);
+    root.set(census.make("dev"), 0);
+    bin.set(census.make("..", false), 0);
+    root.set(census.make("bin"), 0);
+
+    // DeviceFileSystem
+    census.lookup("/dev");
+    dev.set(census.make("tty"), 0);
+    dev.set(census.make("heap"), 0);
+
+    census.lookup("/");
+    root.set(census.make("example.txt"), 0);
+
+    // SystemHandler
+    for (usize index = 0; index < 2; ++index)
+        thread_names.push_back(census.make(Std::ImmutableString::format("Kernel: SystemHandler Worker {}", index)));
+    thread_names.push_back(census.make("Kernel: SystemHandler"));
+
+    // create_shell_process
+    census.lookup("/bin/Shell.elf");
+    auto host_path = census.make("Userland/Shell.1.elf");
+    census.make("/bin/Shell.elf", false);
+    auto process_name = census.make("/bin/Shell.elf");
+    auto working_directory = census.make("/");
+    thread_names.push_back(census.make(Std::ImmutableString::format("Process: {}", "/bin/Shell.elf")));
+
+    census.add_unused_slots(root);
+    census.add_unused_slots(dev);
+    census.add_unused_slots(bin);
+
+    census.report("boot", instance_allocations() - allocations);
+}
+
+// Mirrors 'Thread::sys$posix_spawn' when 'Example.elf' is entered in the shell.
+static void spawn()
+{
+    Census census;
+    usize allocations = instance_allocations();
+
+    census.make("Example.elf", false);
+    census.make("/bin/Example.elf", false);
+
+    Std::HashMap<Std::ImmutableString, Std::ImmutableString> system_to_host;
+    system_to_host.set(census.make("/bin/Shell.elf", false), census.make("Userland/Shell.1.elf", false));
+    system_to_host.set(census.make("/bin/Example.elf", false), census.make("Userland/Example.1.elf"));
+    system_to_host.set(census.make("/bin/Editor.elf", false), census.make("Userland/Editor.1.elf", false));
+
+    auto process_name = census.make("/bin/Example.elf");
+    auto working_directory = census.make("/");
+    auto thread_name = census.make(Std::ImmutableString::format("Process: {}", "/bin/Example.elf"));
+
+    census.report("spawn 'Example.elf'", instance_allocations() - allocations);
+}
+
+int main()
+{
+    std::printf("Allocations are counted for every string that is constructed, live bytes only for strings that are\n"
+                "kept.  The measured allocations are for the 8 byte layout, every instance also allocates a buffer.\n\n");
+
+    boot();
+    spawn();
+
+    return 0;
+}
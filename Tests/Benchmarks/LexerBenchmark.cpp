@@ -0,0 +1,101 @@
+// Measures the throughput of the 'Lexer' scanning methods, compared with consuming one character at a time as
+// 'consume_until' did before.  The RP2040 has no vector unit, build with '-fno-tree-vectorize' to get comparable
+// numbers.
+//
+//     LexerBenchmark [--count <iterations>]
+
+#include <Std/Lexer.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+
+// This is how 'consume_until' was implemented before, only the size of the result is needed here.
+__attribute__((noinline))
+static usize legacy_consume_until(Std::Lexer& lexer, char ch)
+{
+    usize size = 0;
+    while (!lexer.eof() && lexer.peek().value_or(0) != ch) {
+        lexer.consume();
+        ++size;
+    }
+    return size;
+}
+
+static double measure(usize count, const std::function<void(usize)>& callback)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (usize index = 0; index < count; ++index)
+        callback(index);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+// Prevents the compiler from optimizing the result away.
+static usize checksum = 0;
+
+int main(int argc, char **argv)
+{
+    usize count = 2000;
+
+    for (int index = 1; index < argc; ++index) {
+        if (std::strcmp(argv[index], "--count") == 0 && index + 1 < argc)
+            count = std::strtoul(argv[++index], nullptr, 0);
+    }
+
+    std::string text;
+    for (usize line = 0; line < 64; ++line)
+        text += "The quick brown fox jumps over the lazy dog, " + std::to_string(line) + " times.\n";
+
+    std::string spaces(text.size(), ' ');
+    spaces += "x";
+
+    Std::StringView input { text.data(), text.size() };
+
+    std::printf("%zu iterations of %zu bytes, megabytes per second\n\n", count, text.size());
+    std::printf("%-44s %10s\n", "operation", "throughput");
+
+    auto report = [&](const char *name, double nanoseconds) {
+        std::printf("%-44s %10.1f\n", name, text.size() / nanoseconds * 1000.0);
+    };
+
+    report("consume_until, one character at a time", measure(count, [&](usize) {
+        Std::Lexer lexer { input };
+        while (!lexer.eof()) {
+            checksum += legacy_consume_until(lexer, '\n');
+            lexer.try_consume('\n');
+        }
+    }));
+
+    report("consume_until", measure(count, [&](usize) {
+        Std::Lexer lexer { input };
+        while (!lexer.eof()) {
+            checksum += lexer.consume_until('\n').size();
+            lexer.try_consume('\n');
+        }
+    }));
+
+    report("consume_until_any_of, three delimiters", measure(count, [&](usize) {
+        Std::Lexer lexer { input };
+        while (!lexer.eof()) {
+            checksum += lexer.consume_until_any_of(",.\n").size();
+            lexer.consume();
+        }
+    }));
+
+    report("consume_while", measure(count, [&](usize) {
+        Std::Lexer lexer { Std::StringView { spaces.data(), spaces.size() } };
+        checksum += lexer.consume_while(' ').size();
+    }));
+
+    report("consume_while_any_of, two characters", measure(count, [&](usize) {
+        Std::Lexer lexer { Std::StringView { spaces.data(), spaces.size() } };
+        checksum += lexer.consume_while_any_of(" \t").size();
+    }));
+
+    std::printf("\nchecksum %zu\n", checksum);
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Compares lookups in 'Std::HashMap<ImmutableString, ...>' with the word-at-a-time hash and the hash that is cached
+// in 'ImmutableStringInstance' against the byte by byte djb2 hash that was used before.
+//
+//     StringHashBenchmark [--count <lookups>]
+
+#include <Std/HashMap.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+// This is how strings were hashed before, http://www.cse.yorku.ca/~oz/hash.html
+struct LegacyKey {
+    Std::ImmutableString m_string;
+
+    u32 hash() const
+    {
+        u32 hash = 5381;
+        for (char ch : m_string.view().iter())
+            hash = ((hash << 5) + hash) + ch;
+        return hash;
+    }
+
+    bool operator==(const LegacyKey& other) const { return m_string == other.m_string; }
+};
+
+static double measure(const std::function<void()>& callback)
+{
+    auto start = std::chrono::steady_clock::now();
+    callback();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Prevents the compiler from optimizing the result away.
+static usize checksum = 0;
+
+int main(int argc, char **argv)
+{
+    usize count = 20000;
+
+    for (int index = 1; index < argc; ++index) {
+        if (std::strcmp(argv[index], "--count") == 0 && index + 1 < argc)
+            count = std::strtoul(argv[++index], nullptr, 0);
+    }
+
+    // Names like the ones in the root file system and in a typical project directory.
+    const char *stems[] = { "Shell", "Editor", "Example", "README", "CMakeLists", "configuration", "FileSystem",
+        "GlobalMemoryAllocator", "SystemHandler", "kernel-panic-2021-08-14", "tty" };
+    const char *extensions[] = { ".elf", ".txt", ".cpp", ".hpp", ".md", "" };
+
+    std::vector<std::string> names;
+    for (const char *stem : stems) {
+        for (const char *extension : extensions) {
+            for (usize index = 0; index < 4; ++index)
+                names.push_back(std::string { stem } + (index > 0 ? std::to_string(index) : "") + extension);
+        }
+    }
+
+    std::vector<Std::ImmutableString> keys;
+    for (auto& name : names)
+        keys.push_back(Std::StringView { name.data(), name.size() });
+
+    Std::HashMap<Std::ImmutableString, usize> map;
+    Std::HashMap<LegacyKey, usize> legacy_map;
+    for (usize index = 0; index < keys.size(); ++index) {
+        map.set(keys[index], index);
+        legacy_map.set(LegacyKey { keys[index] }, index);
+    }
+
+    // The same components are looked up again and again when paths are resolved.
+    std::mt19937 prng { 1361245623 };
+    std::vector<usize> order;
+    for (usize index = 0; index < count; ++index)
+        order.push_back(prng() % keys.size());
+
+    std::vector<LegacyKey> legacy_keys;
+    for (auto& key : keys)
+        legacy_keys.push_back({ key });
+
+    std::printf("%zu names, %zu lookups, nanoseconds per lookup\n\n", keys.size(), count);
+    std::printf("%-40s %10s\n", "lookup", "time");
+
+    auto report = [&](const char *name, double time) {
+        std::printf("%-40s %10.1f\n", name, time / count);
+    };
+
+    report("djb2, ImmutableString", measure([&] {
+        for (usize index : order)
+            checksum += *legacy_map.get(legacy_keys[index]);
+    }));
+
+    report("murmur3, StringView", measure([&] {
+        for (usize index : order)
+            checksum += *map.find(keys[index].view());
+    }));
+
+    report("murmur3, ImmutableString, cached hash", measure([&] {
+        for (usize index : order)
+            checksum += *map.get(keys[index]);
+    }));
+
+    // How evenly the keys are distributed matters more than the time to compute the hash.
+    auto collisions = [&](auto&& hash) {
+        std::vector<bool> used(256);
+        usize collisions = 0;
+        for (auto& key : keys) {
+            usize bucket = hash(key) % used.size();
+            collisions += used[bucket];
+            used[bucket] = true;
+        }
+        return collisions;
+    };
+
+    std::printf("\nbucket collisions of %zu names in 256 buckets: djb2 %zu, murmur3 %zu\n", keys.size(),
+        collisions([](auto& key) { return LegacyKey { key }.hash(); }),
+        collisions([](auto& key) { return key.hash(); }));
+
+    std::printf("\nchecksum %zu\n", checksum);
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include <Tests/TestSuite.hpp>
+
+extern "C" {
+#include <Userland/LibC/heap.h>
+}
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+// This is the heap size of userland processes, see 'Userland/Userland.x'.
+constexpr usize heap_size = 0x1000;
+
+alignas(4) static u8 memory[heap_size];
+
+static struct heap_statistics statistics(struct heap& heap)
+{
+    struct heap_statistics stats;
+    heap_statistics(&heap, &stats);
+    return stats;
+}
+
+TEST_CASE(heap)
+{
+    struct heap heap;
+    heap_initialize(&heap, memory, sizeof(memory));
+
+    usize initial_free_bytes = statistics(heap).free_bytes;
+    ASSERT(statistics(heap).largest_free_block == initial_free_bytes);
+
+    auto *pointer1 = reinterpret_cast<u8*>(heap_allocate(&heap, 13));
+    auto *pointer2 = reinterpret_cast<u8*>(heap_allocate(&heap, 64));
+
+    ASSERT(pointer1 != nullptr && pointer2 != nullptr);
+    ASSERT(uptr(pointer1) % 4 == 0 && uptr(pointer2) % 4 == 0);
+    ASSERT(heap_usable_size(&heap, pointer1) >= 13);
+
+    std::memset(pointer1, 0xaa, 13);
+    std::memset(pointer2, 0xbb, 64);
+
+    auto stats = statistics(heap);
+    ASSERT(stats.live_allocations == 2);
+    ASSERT(stats.allocations == 2);
+    ASSERT(stats.used_bytes >= 13 + 64);
+
+    heap_deallocate(&heap, pointer1);
+    heap_deallocate(&heap, pointer2);
+    heap_deallocate(&heap, nullptr);
+
+    // Everything is merged again.
+    stats = statistics(heap);
+    ASSERT(stats.live_allocations == 0);
+    ASSERT(stats.used_bytes == 0);
+    ASSERT(stats.free_bytes == initial_free_bytes);
+    ASSERT(stats.largest_free_block == initial_free_bytes);
+    ASSERT(stats.peak_used_bytes >= 13 + 64);
+}
+
+TEST_CASE(heap_out_of_memory)
+{
+    struct heap heap;
+    heap_initialize(&heap, memory, sizeof(memory));
+
+    ASSERT(heap_allocate(&heap, heap_size) == nullptr);
+    ASSERT(heap_allocate(&heap, usize(-1)) == nullptr);
+
+    std::vector<void*> pointers;
+    while (void *pointer = heap_allocate(&heap, 256))
+        pointers.push_back(pointer);
+
+    ASSERT(pointers.size() >= heap_size / 256 - 2);
+    ASSERT(statistics(heap).failed_allocations == 3);
+
+    // The old block must stay valid if 'realloc' fails.
+    std::memset(pointers[0], 0x42, 256);
+    ASSERT(heap_reallocate(&heap, pointers[0], 2 * KiB) == nullptr);
+    ASSERT(reinterpret_cast<u8*>(pointers[0])[255] == 0x42);
+
+    for (void *pointer : pointers)
+        heap_deallocate(&heap, pointer);
+
+    ASSERT(heap_allocate(&heap, 2 * KiB) != nullptr);
+}
+
+TEST_CASE(heap_reallocate)
+{
+    struct heap heap;
+    heap_initialize(&heap, memory, sizeof(memory));
+
+    auto *pointer = reinterpret_cast<u8*>(heap_reallocate(&heap, nullptr, 16));
+    ASSERT(pointer != nullptr);
+    for (usize index = 0; index < 16; ++index)
+        pointer[index] = index;
+
+    // The block after this one is free, thus it grows in place.
+    ASSERT(heap_reallocate(&heap, pointer, 128) == pointer);
+    ASSERT(heap_usable_size(&heap, pointer) >= 128);
+
+    // Now something is in the way.
+    void *blocker = heap_allocate(&heap, 16);
+    auto *new_pointer = reinterpret_cast<u8*>(heap_reallocate(&heap, pointer, 512));
+    ASSERT(new_pointer != nullptr && new_pointer != pointer);
+    for (usize index = 0; index < 16; ++index)
+        ASSERT(new_pointer[index] == index);
+
+    // Shrinking never moves the block.
+    ASSERT(heap_reallocate(&heap, new_pointer, 8) == new_pointer);
+
+    heap_deallocate(&heap, new_pointer);
+    heap_deallocate(&heap, blocker);
+
+    auto stats = statistics(heap);
+    ASSERT(stats.live_allocations == 0);
+    ASSERT(stats.largest_free_block == stats.free_bytes);
+}
+
+// This is what the shell does: 'readline' allocates a buffer for every line which is freed after it was executed.
+// Previously, this exhausted the heap after a few lines.
+TEST_CASE(heap_long_running)
+{
+    struct heap heap;
+    heap_initialize(&heap, memory, sizeof(memory));
+
+    usize initial_free_bytes = statistics(heap).free_bytes;
+
+    std::mt19937 prng { 42 };
+    std::vector<void*> pointers;
+
+    for (usize iteration = 0; iteration < 100000; ++iteration) {
+        void *line = heap_allocate(&heap, 256);
+        ASSERT(line != nullptr);
+
+        if (pointers.size() < 8 && prng() % 2 == 0) {
+            void *pointer = heap_allocate(&heap, 1 + prng() % 128);
+            ASSERT(pointer != nullptr);
+            pointers.push_back(pointer);
+        } else if (pointers.size() > 0) {
+            usize index = prng() % pointers.size();
+
+            void *pointer = heap_reallocate(&heap, pointers[index], 1 + prng() % 128);
+            ASSERT(pointer != nullptr);
+
+            if (prng() % 2 == 0) {
+                heap_deallocate(&heap, pointer);
+                pointers.erase(pointers.begin() + index);
+            } else {
+                pointers[index] = pointer;
+            }
+        }
+
+        heap_deallocate(&heap, line);
+    }
+
+    for (void *pointer : pointers)
+        heap_deallocate(&heap, pointer);
+
+    auto stats = statistics(heap);
+    ASSERT(stats.failed_allocations == 0);
+    ASSERT(stats.live_allocations == 0);
+    ASSERT(stats.free_bytes == initial_free_bytes);
+    ASSERT(stats.largest_free_block == initial_free_bytes);
+}
+
+TEST_MAIN();
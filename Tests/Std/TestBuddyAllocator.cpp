@@ -0,0 +1,229 @@
+#include <Tests/TestSuite.hpp>
+
+#include <Std/BuddyAllocator.hpp>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using PageAllocator = Std::BuddyAllocator<8, 18>;
+
+alignas(1 << 18)
+static u8 memory[1 << 18];
+
+static uptr base() { return reinterpret_cast<uptr>(memory); }
+
+TEST_CASE(buddyallocator)
+{
+    PageAllocator allocator { base() };
+
+    ASSERT(!allocator.largest_free_power().is_valid());
+    ASSERT(!allocator.allocate(8).is_valid());
+
+    allocator.add_range(base(), 18);
+    ASSERT(allocator.largest_free_power().must() == 18);
+
+    uptr block1 = allocator.allocate(10).must();
+    uptr block2 = allocator.allocate(10).must();
+
+    ASSERT(block1 == base());
+    ASSERT(block2 == base() + (1 << 10));
+
+    ASSERT(allocator.largest_free_power().must() == 17);
+    ASSERT(allocator.free_bytes() == (1 << 18) - 2 * (1 << 10));
+
+    allocator.deallocate(block1, 10);
+    ASSERT(allocator.is_free(block1, 10));
+    ASSERT(allocator.largest_free_power().must() == 17);
+
+    // Now, the buddies should be merged all the way up.
+    allocator.deallocate(block2, 10);
+    ASSERT(!allocator.is_free(block1, 10));
+    ASSERT(allocator.is_free(base(), 18));
+    ASSERT(allocator.largest_free_power().must() == 18);
+}
+
+TEST_CASE(buddyallocator_reverse_order)
+{
+    PageAllocator allocator { base() };
+    allocator.add_range(base(), 18);
+
+    std::vector<uptr> blocks;
+    for (usize index = 0; index < 16; ++index)
+        blocks.push_back(allocator.allocate(11).must());
+
+    std::reverse(blocks.begin(), blocks.end());
+
+    for (uptr block : blocks)
+        allocator.deallocate(block, 11);
+
+    ASSERT(allocator.largest_free_power().must() == 18);
+    ASSERT(allocator.free_bytes() == 1 << 18);
+}
+
+TEST_CASE(buddyallocator_reserved_memory_is_not_merged)
+{
+    PageAllocator allocator { base() };
+
+    // This is what 'Kernel::PageAllocator' does, the first 8 KiB are used by the boot code.
+    for (usize size = 8 * KiB; size < (1 << 18); size *= 2)
+        allocator.add_range(base() + size, power_of_two(size));
+
+    ASSERT(allocator.largest_free_power().must() == 17);
+    ASSERT(allocator.free_bytes() == (1 << 18) - 8 * KiB);
+
+    uptr block = allocator.allocate(13).must();
+    ASSERT(block == base() + 8 * KiB);
+
+    allocator.deallocate(block, 13);
+    ASSERT(allocator.is_free(base() + 8 * KiB, 13));
+    ASSERT(allocator.largest_free_power().must() == 17);
+}
+
+TEST_CASE(buddyallocator_largest_free_power_is_exact)
+{
+    PageAllocator allocator { base() };
+    allocator.add_range(base(), 18);
+
+    // Take every other 1 KiB block, there is plenty of memory left but nothing larger than 1 KiB.
+    std::vector<uptr> blocks;
+    for (usize index = 0; index < 256; ++index)
+        blocks.push_back(allocator.allocate(10).must());
+    for (usize index = 0; index < 256; index += 2)
+        allocator.deallocate(blocks[index], 10);
+
+    ASSERT(allocator.free_bytes() == 128 * KiB);
+    ASSERT(allocator.largest_free_power().must() == 10);
+    ASSERT(!allocator.allocate(11).is_valid());
+
+    // Freeing a single buddy creates a 2 KiB block.
+    allocator.deallocate(blocks[1], 10);
+    ASSERT(allocator.largest_free_power().must() == 11);
+    ASSERT(allocator.allocate(11).must() == blocks[0]);
+}
+
+TEST_CASE(buddyallocator_prefers_smallest_block)
+{
+    PageAllocator allocator { base() };
+    allocator.add_range(base(), 18);
+
+    uptr block1 = allocator.allocate(8).must();
+    uptr block2 = allocator.allocate(17).must();
+    allocator.deallocate(block1, 8);
+
+    uptr block3 = allocator.allocate(16).must();
+    uptr block4 = allocator.allocate(8).must();
+
+    ASSERT(block2 == base() + 128 * KiB);
+    ASSERT(block3 == base());
+
+    // The remaining 64 KiB block should not be broken up.
+    ASSERT(block4 == base() + 64 * KiB);
+    ASSERT(allocator.largest_free_power().must() == 15);
+}
+
+TEST_CASE(buddyallocator_for_each_allocated_block)
+{
+    PageAllocator allocator { base() };
+
+    for (usize size = 8 * KiB; size < (1 << 18); size *= 2)
+        allocator.add_range(base() + size, power_of_two(size));
+
+    uptr block1 = allocator.allocate(11).must();
+    uptr block2 = allocator.allocate(14).must();
+
+    std::vector<std::pair<uptr, usize>> blocks;
+    allocator.for_each_allocated_block([&](uptr base, usize power) {
+        blocks.push_back({ base, power });
+    });
+
+    // The memory that was never added is reported as well.
+    ASSERT(blocks.size() == 3);
+    ASSERT(blocks[0].first == base() && blocks[0].second == 13);
+    ASSERT(blocks[1].first == block1 && blocks[1].second == 11);
+    ASSERT(blocks[2].first == block2 && blocks[2].second == 14);
+
+    allocator.dump();
+}
+
+// This replays what happens when the shell spawns processes that exit again.
+// Without merging buddies, the 2 KiB stacks would slowly eat up all the large blocks.
+TEST_CASE(buddyallocator_spawn_and_exit)
+{
+    PageAllocator allocator { base() };
+
+    for (usize size = 8 * KiB; size < (1 << 18); size *= 2)
+        allocator.add_range(base() + size, power_of_two(size));
+
+    constexpr usize stack_power = power_of_two(2 * KiB);
+
+    // These allocations are made during boot and live forever.
+    allocator.allocate(power_of_two(16 * KiB)).must();
+    allocator.allocate(power_of_two(1 * KiB)).must();
+    for (usize index = 0; index < 4; ++index)
+        allocator.allocate(stack_power).must();
+
+    usize initial_free_bytes = allocator.free_bytes();
+    usize initial_largest_power = allocator.largest_free_power().must();
+
+    struct Process {
+        uptr m_stack;
+        uptr m_writable;
+        usize m_writable_power;
+    };
+    std::vector<Process> processes;
+
+    std::mt19937 prng { 2912867391 };
+
+    auto spawn = [&] {
+        Process process;
+        process.m_stack = allocator.allocate(stack_power).must();
+
+        // Every system call creates a worker thread with a stack.
+        uptr worker_stack = allocator.allocate(stack_power).must();
+
+        process.m_writable_power = prng() % 2 == 0 ? power_of_two(8 * KiB) : power_of_two(16 * KiB);
+        process.m_writable = allocator.allocate(process.m_writable_power).must();
+
+        allocator.deallocate(worker_stack, stack_power);
+
+        processes.push_back(process);
+    };
+
+    auto exit = [&] {
+        usize index = prng() % processes.size();
+        Process process = processes[index];
+
+        allocator.deallocate(process.m_writable, process.m_writable_power);
+        allocator.deallocate(process.m_stack, stack_power);
+
+        processes.erase(processes.begin() + index);
+    };
+
+    for (usize cycle = 0; cycle < 64; ++cycle) {
+        usize count = 1 + prng() % 4;
+        for (usize index = 0; index < count; ++index)
+            spawn();
+
+        while (processes.size() > 1)
+            exit();
+
+        usize largest_power = allocator.largest_free_power().must();
+
+        if (cycle % 8 == 0) {
+            std::cout << "cycle " << cycle << ": largest free block " << (1 << largest_power) / KiB << " KiB, "
+                      << allocator.free_bytes() / KiB << " KiB free\n";
+        }
+
+        // With a single process running, there should always be a 32 KiB block avaliable.
+        ASSERT(largest_power >= power_of_two(32 * KiB));
+    }
+
+    while (processes.size() > 0)
+        exit();
+
+    ASSERT(allocator.free_bytes() == initial_free_bytes);
+    ASSERT(allocator.largest_free_power().must() == initial_largest_power);
+}
+
+TEST_MAIN();
@@ -3,6 +3,8 @@
 #include <Std/Format.hpp>
 #include <Std/StringView.hpp>
 
+#include <string>
+
 struct A {
 };
 
@@ -16,7 +18,7 @@ TEST_CASE(format)
 {
     auto test = []<typename... Parameters>(std::string_view expected, std::string_view format, const Parameters&... parameters) {
         Std::StringBuilder builder;
-        builder.appendf(Std::StringView { format.data(), format.size() }, parameters...);
+        Std::vformat(builder, Std::StringView { format.data(), format.size() }, Std::VariadicFormatParams { parameters... });
 
         ASSERT((expected == std::string_view { builder.view().data(), builder.view().size() }));
     };
@@ -35,4 +37,91 @@ TEST_CASE(format)
     test("a0x00000020a bXYZb c-0x00000004c", "a{}a b{}b c{}c", u32(32), "XYZ", i32(-4));
 }
 
+template<typename... Parameters>
+static void test_compiled(std::string_view expected, Std::FormatString<typename TypeIdentity<Parameters>::Type...> fmtstr, const Parameters&... parameters)
+{
+    Std::StringBuilder builder;
+    builder.appendf(fmtstr, parameters...);
+
+    ASSERT((expected == std::string_view { builder.view().data(), builder.view().size() }));
+}
+
+TEST_CASE(format_compiled)
+{
+    test_compiled("0x0000002a", "{}", u32(42));
+    test_compiled("-0x00000001", "{}", i32(-1));
+    test_compiled("0x01020304aabbccdd", "{}", u64(0x01020304aabbccddULL));
+    test_compiled("0xab", "{}", u8(0xab));
+
+    test_compiled("foo bar baz", "foo {} baz", "bar");
+    test_compiled("abc", "a{}c", 'b');
+    test_compiled("a0x00000020a bXYZb c-0x00000004c", "a{}a b{}b c{}c", u32(32), "XYZ", i32(-4));
+
+    test_compiled("no placeholders", "no placeholders");
+    test_compiled("{x}", "{{{}}}", 'x');
+    test_compiled("{} }{", "{{}} }}{{");
+}
+
+TEST_CASE(format_specifier)
+{
+    test_compiled("42", "{:d}", u32(42));
+    test_compiled("42", "{:}", u32(42));
+    test_compiled("-42", "{:d}", i32(-42));
+    test_compiled("0", "{:d}", u8(0));
+    test_compiled("4294967295", "{:d}", u32(0xffffffff));
+    test_compiled("18446744073709551615", "{:d}", u64(0xffffffffffffffffULL));
+    test_compiled("-9223372036854775808", "{:d}", i64(-0x7fffffffffffffffLL - 1));
+    test_compiled("-128", "{:d}", i8(-128));
+
+    test_compiled("2a", "{:x}", u32(42));
+    test_compiled("0x2a", "{:#x}", u32(42));
+    test_compiled("0x2a", "{:#}", u32(42));
+    test_compiled("0x0000002a", "{:#010x}", u32(42));
+    test_compiled("-0x002a", "{:#07x}", i32(-42));
+
+    test_compiled("   42", "{:5}", u32(42));
+    test_compiled("00042", "{:05}", u32(42));
+    test_compiled("-0042", "{:05d}", i32(-42));
+    test_compiled("  -42", "{:5d}", i32(-42));
+    test_compiled("123456", "{:3}", u32(123456));
+
+    test_compiled("[ 7] [0x00000007]", "[{:2}] [{}]", u32(7), u32(7));
+}
+
+TEST_CASE(format_fixed_buffer_sink)
+{
+    char buffer[16];
+
+    Std::FixedBufferFormatSink sink { Std::Span<char> { buffer, sizeof(buffer) } };
+    sink.appendf("a={:d} b={}", u32(42), "foo");
+    ASSERT(sink.view() == "a=42 b=foo");
+    ASSERT(!sink.is_truncated());
+
+    sink.appendf(" c={}", u32(1));
+    ASSERT(sink.view() == "a=42 b=foo c=0x0");
+    ASSERT(sink.is_truncated());
+}
+
+// Records every write, nothing is collected in a 'StringBuilder'.
+class RecordingFormatSink final : public Std::FormatSink {
+public:
+    void write(Std::StringView value) override
+    {
+        m_output.append(value.data(), value.size());
+        ++m_writes;
+    }
+
+    std::string m_output;
+    usize m_writes = 0;
+};
+
+TEST_CASE(format_custom_sink)
+{
+    RecordingFormatSink sink;
+    sink.appendf("[{}] {} {:#x}", "Kernel", Std::Optional<u8> {}, u32(255));
+
+    ASSERT(sink.m_output == "[Kernel] nil 0xff");
+    ASSERT(sink.m_writes >= 1);
+}
+
 TEST_MAIN();
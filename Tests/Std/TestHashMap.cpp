@@ -73,4 +73,67 @@ TEST_CASE(hashmap_iterator)
     ASSERT(did_see_pair_5);
 }
 
+TEST_CASE(hashmap_find)
+{
+    Std::HashMap<Std::ImmutableString, int> map;
+
+    map.set("bin", 1);
+    map.set("dev", 2);
+    map.set("example.txt", 3);
+
+    auto& pool = Std::ImmutableStringInstance::object_pool();
+    usize allocations = pool.statistics().m_allocations;
+
+    // Looking up a 'StringView' must not create an 'ImmutableString'.
+    Std::StringView path = "/dev/tty";
+    int *value = map.find(path.substr(1, 4));
+    ASSERT(value != nullptr && *value == 2);
+
+    ASSERT(map.find(Std::StringView { "example.txt" }) != nullptr);
+    ASSERT(map.find(Std::StringView { "example" }) == nullptr);
+    ASSERT(map.find(Std::StringView { "" }) == nullptr);
+
+    ASSERT(pool.statistics().m_allocations == allocations);
+
+    // The result refers to the value in the map.
+    *map.find(Std::StringView { "bin" }) = 42;
+    ASSERT(*map.get("bin") == 42);
+
+    const auto& const_map = map;
+    ASSERT(const_map.find(Std::StringView { "bin" }) != nullptr);
+}
+
+TEST_CASE(hashmap_string_hash)
+{
+    // Reference values of MurmurHash3 with seed zero.
+    ASSERT(Std::StringView { "" }.hash() == 0);
+    ASSERT(Std::StringView { "hello" }.hash() == 0x248bfa47);
+    ASSERT(Std::StringView { "Hello, world!" }.hash() == 0xc0363e43);
+    ASSERT(Std::StringView { "The quick brown fox jumps over the lazy dog" }.hash() == 0x2e4ff723);
+
+    // The hash does not depend on the alignment or on how the string is stored.
+    char buffer[64];
+    Std::StringView name = "configuration.txt";
+    for (usize offset = 0; offset < 8; ++offset) {
+        name.strcpy_to({ buffer + offset, sizeof(buffer) - offset });
+        ASSERT((Std::StringView { buffer + offset, name.size() }.hash() == name.hash()));
+    }
+
+    Std::ImmutableString shared = name;
+    Std::ImmutableString inline_string = "tty";
+    Std::ImmutableString static_string = Std::ImmutableString::from_static("configuration.txt");
+    ASSERT(!shared.is_inline() && inline_string.is_inline() && static_string.is_static());
+
+    ASSERT(Std::Hash<Std::ImmutableString>::compute(shared) == name.hash());
+    ASSERT(Std::Hash<Std::ImmutableString>::compute(static_string) == name.hash());
+    ASSERT(Std::Hash<Std::ImmutableString>::compute(inline_string) == Std::StringView { "tty" }.hash());
+
+    // The cached hash is shared by the copies.
+    Std::ImmutableString copy = shared;
+    ASSERT(copy.hash() == name.hash());
+    ASSERT(shared.hash() == name.hash());
+
+    ASSERT(Std::StringView { "file1" }.hash() != Std::StringView { "file2" }.hash());
+}
+
 TEST_MAIN();
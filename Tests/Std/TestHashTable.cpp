@@ -3,6 +3,8 @@
 #include <Std/HashTable.hpp>
 
 #include <utility>
+#include <random>
+#include <set>
 
 TEST_CASE(hashtable_int)
 {
@@ -105,4 +107,102 @@ TEST_CASE(hashtable_iterator)
     ASSERT(did_see_0);
 }
 
+TEST_CASE(hashtable_remove_shifts_entries)
+{
+    Std::HashTable<A> hash;
+
+    // All of these want the same slot, thus they are stored one after another.
+    for (int value = 0; value < 5; ++value)
+        hash.insert({ 7, value });
+    hash.insert({ 8, 100 });
+
+    hash.remove({ 7, 1 });
+    hash.remove({ 7, 3 });
+
+    ASSERT(hash.size() == 4);
+    ASSERT(hash.search({ 7, 0 }) != nullptr);
+    ASSERT(hash.search({ 7, 2 }) != nullptr);
+    ASSERT(hash.search({ 7, 4 }) != nullptr);
+    ASSERT(hash.search({ 8, 100 }) != nullptr);
+    ASSERT(hash.search({ 7, 1 }) == nullptr);
+    ASSERT(hash.search({ 7, 3 }) == nullptr);
+
+    // Hashes of zero are valid aswell.
+    hash.insert({ 0, 42 });
+    ASSERT(hash.search({ 0, 42 }) != nullptr);
+}
+
+TEST_CASE(hashtable_random)
+{
+    Std::HashTable<u32> hash;
+    std::set<u32> reference;
+
+    std::mt19937 prng { 7 };
+
+    for (usize iteration = 0; iteration < 20000; ++iteration) {
+        u32 value = prng() % 2048;
+
+        if (prng() % 3 == 0) {
+            hash.remove(value);
+            reference.erase(value);
+        } else {
+            hash.insert(value);
+            reference.insert(value);
+        }
+
+        ASSERT(hash.size() == reference.size());
+    }
+
+    // The load factor is kept below 3/4.
+    ASSERT(hash.size() * 4 <= hash.capacity() * 3);
+
+    for (u32 value = 0; value < 2048; ++value)
+        ASSERT((hash.search(value) != nullptr) == reference.contains(value));
+
+    std::set<u32> seen;
+    for (u32 value : hash.iter())
+        ASSERT(seen.insert(value).second);
+    ASSERT(seen == reference);
+
+    hash.clear();
+    ASSERT(hash.size() == 0);
+    ASSERT(hash.iter().begin() == hash.iter().end());
+}
+
+struct B {
+    static inline int m_live_count = 0;
+
+    int m_value;
+
+    B(int value) : m_value(value) { ++m_live_count; }
+    B(const B& other) : m_value(other.m_value) { ++m_live_count; }
+    B(B&& other) : m_value(other.m_value) { ++m_live_count; }
+    ~B() { --m_live_count; }
+
+    B& operator=(const B&) = default;
+    B& operator=(B&&) = default;
+
+    bool operator==(const B& other) const { return m_value == other.m_value; }
+
+    u32 hash() const { return Std::Hash<int>::compute(m_value); }
+};
+
+TEST_CASE(hashtable_destroys_entries)
+{
+    {
+        Std::HashTable<B> hash;
+
+        for (int value = 0; value < 100; ++value)
+            hash.insert(B { value });
+
+        for (int value = 0; value < 100; value += 2)
+            hash.remove(B { value });
+
+        ASSERT(hash.size() == 50);
+        ASSERT(B::m_live_count == 50);
+    }
+
+    ASSERT(B::m_live_count == 0);
+}
+
 TEST_MAIN();
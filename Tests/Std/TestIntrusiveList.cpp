@@ -0,0 +1,210 @@
+#include <Tests/TestSuite.hpp>
+
+#include <Std/IntrusiveList.hpp>
+#include <Std/Vector.hpp>
+
+struct A {
+    int m_value;
+    Std::IntrusiveListNode<A> m_node;
+};
+
+using AList = Std::IntrusiveList<A, &A::m_node>;
+
+TEST_CASE(intrusivelist)
+{
+    A a { 1 }, b { 2 }, c { 3 };
+    AList list;
+
+    ASSERT(list.is_empty());
+
+    list.enqueue(a);
+    list.enqueue(b);
+    list.enqueue(c);
+
+    ASSERT(list.size() == 3);
+    ASSERT(list.front().m_value == 1);
+    ASSERT(list.back().m_value == 3);
+
+    ASSERT(list.dequeue().m_value == 1);
+    ASSERT(list.dequeue().m_value == 2);
+    ASSERT(list.dequeue().m_value == 3);
+
+    ASSERT(list.is_empty());
+    ASSERT(!a.m_node.is_linked());
+}
+
+TEST_CASE(intrusivelist_enqueue_front)
+{
+    A a { 1 }, b { 2 };
+    AList list;
+
+    list.enqueue(a);
+    list.enqueue_front(b);
+
+    ASSERT(list.dequeue().m_value == 2);
+    ASSERT(list.dequeue().m_value == 1);
+}
+
+TEST_CASE(intrusivelist_remove)
+{
+    A a { 1 }, b { 2 }, c { 3 };
+    AList list;
+
+    list.enqueue(a);
+    list.enqueue(b);
+    list.enqueue(c);
+
+    list.remove(b);
+
+    ASSERT(list.size() == 2);
+    ASSERT(!list.contains(b));
+    ASSERT(list.contains(a));
+
+    ASSERT(list.dequeue().m_value == 1);
+    ASSERT(list.dequeue().m_value == 3);
+
+    list.enqueue(a);
+    list.enqueue(b);
+    list.remove(b);
+    list.remove(a);
+
+    ASSERT(list.is_empty());
+
+    // An object can be moved to another list after it was removed.
+    AList other_list;
+    other_list.enqueue(a);
+    ASSERT(other_list.contains(a));
+    ASSERT(!list.contains(a));
+}
+
+TEST_CASE(intrusivelist_iter)
+{
+    A values[20];
+    AList list;
+
+    for (int index = 0; index < 20; ++index) {
+        values[index].m_value = index;
+        list.enqueue(values[index]);
+    }
+
+    ASSERT(list.size() == 20);
+
+    int expected = 0;
+    for (A& value : list.iter())
+        ASSERT(value.m_value == expected++);
+    ASSERT(expected == 20);
+
+    list.clear();
+
+    ASSERT(list.is_empty());
+    for (A& value : values)
+        ASSERT(!value.m_node.is_linked());
+}
+
+struct B : Tests::Tracker, Std::RefCounted<B> {
+    B() : Tests::Tracker() { }
+
+    Std::IntrusiveListNode<B> m_node;
+};
+
+using BList = Std::IntrusiveRefList<B, &B::m_node>;
+
+TEST_CASE(intrusivereflist)
+{
+    Tests::Tracker::clear();
+
+    {
+        BList list;
+
+        auto b1 = B::construct();
+        auto b2 = B::construct();
+
+        list.enqueue(b1);
+        list.enqueue(move(b2));
+
+        ASSERT(b1->refcount() == 2);
+        ASSERT(b2.is_null());
+
+        auto b3 = list.dequeue();
+        ASSERT(b3.ptr() == b1.ptr());
+        ASSERT(b1->refcount() == 2);
+
+        Tests::Tracker::assert(2, 0, 0, 0);
+
+        // The remaining entry is released when the list is destroyed.
+    }
+
+    Tests::Tracker::assert(2, 0, 0, 2);
+}
+
+TEST_CASE(intrusivereflist_remove)
+{
+    Tests::Tracker::clear();
+
+    {
+        BList list;
+
+        Std::Vector<B*> pointers;
+        for (usize index = 0; index < 32; ++index) {
+            auto b = B::construct();
+            pointers.append(b.ptr());
+            list.enqueue(move(b));
+        }
+
+        ASSERT(list.size() == 32);
+
+        auto removed = list.remove(*pointers[10]);
+        ASSERT(removed->refcount() == 1);
+        ASSERT(list.size() == 31);
+
+        removed.clear();
+        Tests::Tracker::assert(32, 0, 0, 1);
+
+        list.clear();
+        Tests::Tracker::assert(32, 0, 0, 32);
+    }
+
+    Tests::Tracker::assert(32, 0, 0, 32);
+}
+
+TEST_CASE(intrusivereflist_wakeup_while_waiting)
+{
+    Tests::Tracker::clear();
+
+    {
+        // This is how 'Thread::wakeup' treats a thread that is waiting for a 'KernelMutex'.
+        BList waiting_list;
+        BList scheduled_list;
+
+        auto wakeup = [&](B& b) {
+            if (!b.m_node.is_linked())
+                scheduled_list.enqueue(b);
+        };
+
+        auto b = B::construct();
+        waiting_list.enqueue(b);
+
+        // The object must not be linked into a second list while it is waiting.
+        wakeup(*b);
+        ASSERT(b->m_node.is_linked());
+        ASSERT(waiting_list.contains(*b));
+        ASSERT(!scheduled_list.contains(*b));
+        ASSERT(scheduled_list.is_empty());
+        ASSERT(b->refcount() == 2);
+
+        // Once it is dequeued, it can be woken up.
+        auto dequeued = waiting_list.dequeue();
+        wakeup(*dequeued);
+        ASSERT(scheduled_list.contains(*b));
+        ASSERT(scheduled_list.size() == 1);
+        ASSERT(b->refcount() == 3);
+
+        scheduled_list.clear();
+        ASSERT(!b->m_node.is_linked());
+        ASSERT(b->refcount() == 2);
+    }
+
+    Tests::Tracker::assert(1, 0, 0, 1);
+}
+
+TEST_MAIN();
@@ -22,4 +22,68 @@ TEST_CASE(lexer)
     ASSERT(!lexer.try_consume('\n'));
 }
 
+TEST_CASE(lexer_consume_until_any_of)
+{
+    Std::Lexer lexer { "key=value;other:x" };
+
+    ASSERT(lexer.consume_until_any_of("=:;") == "key");
+    ASSERT(lexer.try_consume('='));
+    ASSERT(lexer.consume_until_any_of("=:;") == "value");
+    ASSERT(lexer.try_consume(';'));
+    ASSERT(lexer.consume_until_any_of(":;") == "other");
+    ASSERT(lexer.consume_until_any_of(":") == "");
+    ASSERT(lexer.try_consume(':'));
+    ASSERT(lexer.consume_until_any_of(":;") == "x");
+    ASSERT(lexer.eof());
+    ASSERT(lexer.consume_until_any_of(":;") == "");
+}
+
+TEST_CASE(lexer_consume_while)
+{
+    Std::Lexer lexer { "   \t foo//bar" };
+
+    ASSERT(lexer.consume_while_any_of(" \t") == "   \t ");
+    ASSERT(lexer.consume_while('/') == "");
+    ASSERT(lexer.consume_while_any_of("abcdefghijklmnopqrstuvwxyz") == "foo");
+    ASSERT(lexer.consume_while('/') == "//");
+    ASSERT(lexer.consume_while_any_of("abr") == "bar");
+    ASSERT(lexer.eof());
+}
+
+// Every combination of alignment, length and position of the delimiter, words are scanned in the middle.
+TEST_CASE(lexer_scan_alignment)
+{
+    char buffer[64];
+
+    for (usize offset = 0; offset < 8; ++offset) {
+        for (usize size = 0; size < 40; ++size) {
+            for (usize position = 0; position <= size; ++position) {
+                __builtin_memset(buffer, 'a', sizeof(buffer));
+                if (position < size)
+                    buffer[offset + position] = ',';
+
+                // The characters outside of the input must be ignored.
+                buffer[offset + size] = ';';
+                if (offset > 0)
+                    buffer[offset - 1] = ',';
+
+                Std::StringView input { buffer + offset, size };
+
+                Std::Lexer until_char { input };
+                ASSERT(until_char.consume_until(',').size() == position);
+                ASSERT(until_char.remaining() == size - position);
+
+                Std::Lexer until_any { input };
+                ASSERT(until_any.consume_until_any_of(";,").size() == position);
+
+                Std::Lexer while_char { input };
+                ASSERT(while_char.consume_while('a').size() == position);
+
+                Std::Lexer while_any { input };
+                ASSERT(while_any.consume_while_any_of("ab").size() == position);
+            }
+        }
+    }
+}
+
 TEST_MAIN();
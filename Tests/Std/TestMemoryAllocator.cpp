@@ -6,6 +6,7 @@
 #include <vector>
 #include <algorithm>
 #include <functional>
+#include <map>
 #include <random>
 
 // We are making some assumptions here about the nature of the implementation
@@ -64,4 +65,439 @@ TEST_CASE(memoryallocator_death_by_a_thousand_cuts)
     ASSERT(stats_before.m_largest_continous_block == stats_after.m_largest_continous_block);
 }
 
+TEST_CASE(memoryallocator_alignment)
+{
+    std::array<uint8_t, 0x400> heap;
+
+    Std::MemoryAllocator mem { { heap.data(), heap.size() } };
+
+    for (usize size = 0; size < 32; ++size) {
+        u8 *pointer = mem.allocate(size);
+        ASSERT(usize(pointer) % 4 == 0);
+
+        std::memset(pointer, 0xff, size);
+    }
+}
+
+TEST_CASE(memoryallocator_merge_both_sides)
+{
+    std::array<uint8_t, 0x400> heap;
+
+    Std::MemoryAllocator mem { { heap.data(), heap.size() } };
+
+    auto stats_before = mem.statistics();
+
+    u8 *pointer1 = mem.allocate(40);
+    u8 *pointer2 = mem.allocate(12);
+    u8 *pointer3 = mem.allocate(100);
+
+    mem.deallocate(pointer1);
+    mem.deallocate(pointer3);
+
+    // The middle block is surrounded by free blocks now and must be merged with both of them.
+    mem.deallocate(pointer2);
+
+    auto stats_after = mem.statistics();
+
+    ASSERT(stats_before.m_largest_continous_block == stats_after.m_largest_continous_block);
+    ASSERT(stats_before.m_avaliable_memory == stats_after.m_avaliable_memory);
+}
+
+TEST_CASE(memoryallocator_reuse_freed_block)
+{
+    std::array<uint8_t, 0x800> heap;
+
+    Std::MemoryAllocator mem { { heap.data(), heap.size() } };
+
+    // Together with the header, this is exactly the lower bound of a size class.
+    u8 *pointer1 = mem.allocate(188);
+    u8 *pointer2 = mem.allocate(16);
+
+    mem.deallocate(pointer1);
+
+    // The freed block is a perfect fit, it should be reused instead of splitting the large block.
+    u8 *pointer3 = mem.allocate(188);
+    ASSERT(pointer3 == pointer1);
+
+    mem.deallocate(pointer2);
+    mem.deallocate(pointer3);
+}
+
+TEST_CASE(memoryallocator_random_sizes)
+{
+    std::array<uint8_t, 0x8000> heap;
+
+    Std::MemoryAllocator mem { { heap.data(), heap.size() } };
+
+    auto stats_before = mem.statistics();
+
+    struct Allocation {
+        u8 *m_pointer;
+        usize m_size;
+        u8 m_pattern;
+    };
+    std::vector<Allocation> allocations;
+
+    std::mt19937 prng { 1952392613 };
+    std::uniform_int_distribution<usize> size_distribution { 0, 300 };
+
+    for (usize round = 0; round < 2000; ++round) {
+        if (allocations.size() > 0 && (prng() % 3 == 0 || allocations.size() >= 64)) {
+            usize index = prng() % allocations.size();
+            Allocation allocation = allocations[index];
+
+            for (usize i = 0; i < allocation.m_size; ++i)
+                ASSERT(allocation.m_pointer[i] == allocation.m_pattern);
+
+            mem.deallocate(allocation.m_pointer);
+
+            allocations[index] = allocations.back();
+            allocations.pop_back();
+        } else {
+            Allocation allocation;
+            allocation.m_size = size_distribution(prng);
+            allocation.m_pointer = mem.allocate(allocation.m_size);
+            allocation.m_pattern = u8(round);
+
+            ASSERT(allocation.m_pointer >= heap.data());
+            ASSERT(allocation.m_pointer + allocation.m_size <= heap.data() + heap.size());
+
+            std::memset(allocation.m_pointer, allocation.m_pattern, allocation.m_size);
+
+            allocations.push_back(allocation);
+        }
+    }
+
+    for (auto& allocation : allocations)
+        mem.deallocate(allocation.m_pointer);
+
+    auto stats_after = mem.statistics();
+
+    ASSERT(stats_before.m_largest_continous_block == stats_after.m_largest_continous_block);
+}
+
+TEST_CASE(memoryallocator_reallocate_grow_in_place)
+{
+    std::array<uint8_t, 0x400> heap;
+
+    Std::MemoryAllocator mem { { heap.data(), heap.size() } };
+
+    u8 *pointer1 = mem.allocate(32);
+    std::memset(pointer1, 0x11, 32);
+
+    // The rest of the heap follows directly after this allocation.
+    u8 *pointer2 = mem.reallocate(pointer1, 200);
+    ASSERT(pointer2 == pointer1);
+
+    for (usize i = 0; i < 32; ++i)
+        ASSERT(pointer2[i] == 0x11);
+
+    mem.deallocate(pointer2);
+}
+
+TEST_CASE(memoryallocator_reallocate_grow_moves)
+{
+    std::array<uint8_t, 0x400> heap;
+
+    Std::MemoryAllocator mem { { heap.data(), heap.size() } };
+
+    u8 *pointer1 = mem.allocate(32);
+    u8 *pointer2 = mem.allocate(32);
+    std::memset(pointer1, 0x22, 32);
+
+    // The next block is in use, thus we have to move.
+    u8 *pointer3 = mem.reallocate(pointer1, 64);
+    ASSERT(pointer3 != pointer1);
+
+    for (usize i = 0; i < 32; ++i)
+        ASSERT(pointer3[i] == 0x22);
+
+    mem.deallocate(pointer2);
+    mem.deallocate(pointer3);
+}
+
+TEST_CASE(memoryallocator_reallocate_shrink)
+{
+    std::array<uint8_t, 0x400> heap;
+
+    Std::MemoryAllocator mem { { heap.data(), heap.size() } };
+
+    auto stats_before = mem.statistics();
+
+    u8 *pointer1 = mem.allocate(256);
+    u8 *pointer2 = mem.allocate(16);
+
+    auto stats_middle = mem.statistics();
+
+    u8 *pointer3 = mem.reallocate(pointer1, 16);
+    ASSERT(pointer3 == pointer1);
+
+    // The tail has to be returned to the allocator.
+    auto stats_after = mem.statistics();
+    ASSERT(stats_after.m_avaliable_memory > stats_middle.m_avaliable_memory + 200);
+
+    mem.deallocate(pointer2);
+    mem.deallocate(pointer3);
+
+    ASSERT(mem.statistics().m_largest_continous_block == stats_before.m_largest_continous_block);
+}
+
+TEST_CASE(memoryallocator_reallocate_null)
+{
+    std::array<uint8_t, 0x400> heap;
+
+    Std::MemoryAllocator mem { { heap.data(), heap.size() } };
+
+    u8 *pointer = mem.reallocate(nullptr, 24);
+    ASSERT(pointer != nullptr);
+
+    std::memset(pointer, 0xff, 24);
+    mem.deallocate(pointer);
+}
+
+TEST_CASE(memoryallocator_try_expand)
+{
+    std::array<uint8_t, 0x400> heap;
+
+    Std::MemoryAllocator mem { { heap.data(), heap.size() } };
+
+    u8 *pointer1 = mem.allocate(16);
+    u8 *pointer2 = mem.allocate(16);
+    u8 *pointer3 = mem.allocate(16);
+
+    // The next block is in use.
+    ASSERT(!mem.try_expand(pointer2, 64));
+
+    mem.deallocate(pointer3);
+
+    ASSERT(mem.try_expand(pointer2, 64));
+    std::memset(pointer2, 0xff, 64);
+
+    // The next block can not be larger than the heap.
+    ASSERT(!mem.try_expand(pointer2, 0x800));
+
+    // Shrinking always works.
+    ASSERT(mem.try_expand(pointer2, 4));
+
+    mem.deallocate(pointer1);
+    mem.deallocate(pointer2);
+}
+
+TEST_CASE(memoryallocator_trace_buffer)
+{
+    std::array<uint8_t, 0x400> heap;
+    std::array<Std::MemoryTraceRecord, 8> records;
+
+    Std::MemoryAllocator mem { { heap.data(), heap.size() } };
+    mem.set_trace_buffer({ records.data(), records.size() });
+
+    void *caller = reinterpret_cast<void*>(0x10001234);
+
+    u8 *pointer1 = mem.allocate(16, true, caller);
+    u8 *pointer2 = mem.reallocate(pointer1, 64, true, caller);
+    mem.deallocate(pointer2, true, caller);
+
+    // These are not traced.
+    mem.deallocate(mem.allocate(16, false), false);
+
+    ASSERT(mem.trace_buffer().size() == 4);
+
+    std::array<Std::MemoryTraceRecord, 8> output;
+    ASSERT(mem.trace_buffer().drain({ output.data(), output.size() }) == 4);
+    ASSERT(mem.trace_buffer().size() == 0);
+
+    using Std::MemoryTraceOperation;
+
+    ASSERT(output[0].m_operation == MemoryTraceOperation::Allocate);
+    ASSERT(output[0].m_caller == 0x10001234);
+    ASSERT(output[0].m_pointer == u32(uptr(pointer1)));
+    ASSERT(output[0].m_size == 16);
+
+    ASSERT(output[1].m_operation == MemoryTraceOperation::ReallocateFrom);
+    ASSERT(output[1].m_pointer == u32(uptr(pointer1)));
+
+    ASSERT(output[2].m_operation == MemoryTraceOperation::ReallocateTo);
+    ASSERT(output[2].m_pointer == u32(uptr(pointer2)));
+    ASSERT(output[2].m_size == 64);
+
+    ASSERT(output[3].m_operation == MemoryTraceOperation::Deallocate);
+    ASSERT(output[3].m_pointer == u32(uptr(pointer2)));
+}
+
+TEST_CASE(memoryallocator_call_sites)
+{
+    std::array<uint8_t, 0x1000> heap;
+    std::array<Std::MemoryAllocator::CallSite, 4> call_sites;
+
+    Std::MemoryAllocator mem { { heap.data(), heap.size() } };
+
+    // This is allocated before accounting is enabled.
+    u8 *pointer0 = mem.allocate(16);
+
+    mem.set_call_site_table({ call_sites.data(), call_sites.size() });
+
+    void *caller1 = reinterpret_cast<void*>(0x10001000);
+    void *caller2 = reinterpret_cast<void*>(0x10002000);
+
+    u8 *pointer1 = mem.allocate(16, true, caller1);
+    u8 *pointer2 = mem.allocate(32, true, caller1);
+    u8 *pointer3 = mem.allocate(64, true, caller2);
+
+    auto find = [&](void *caller) -> Std::MemoryAllocator::CallSite& {
+        for (auto& call_site : call_sites) {
+            if (call_site.m_caller == uptr(caller))
+                return call_site;
+        }
+        VERIFY_NOT_REACHED();
+    };
+
+    ASSERT(find(caller1).m_live_bytes == 48);
+    ASSERT(find(caller1).m_live_allocations == 2);
+    ASSERT(find(caller2).m_live_bytes == 64);
+
+    mem.deallocate(pointer1);
+    ASSERT(find(caller1).m_live_bytes == 32);
+    ASSERT(find(caller1).m_live_allocations == 1);
+    ASSERT(find(caller1).m_peak_bytes == 48);
+    ASSERT(find(caller1).m_allocations == 2);
+
+    // Growing in place is accounted to the original call site.
+    mem.deallocate(pointer3);
+    u8 *pointer4 = mem.reallocate(pointer2, 96, true, caller2);
+    ASSERT(pointer4 == pointer2);
+    ASSERT(find(caller1).m_live_bytes == 96);
+    ASSERT(find(caller1).m_peak_bytes == 96);
+    ASSERT(find(caller2).m_live_bytes == 0);
+
+    // Not accounted, since it was allocated before.
+    mem.deallocate(pointer0);
+
+    mem.deallocate(pointer4);
+    ASSERT(find(caller1).m_live_bytes == 0);
+    ASSERT(find(caller1).m_live_allocations == 0);
+
+    mem.dump_call_sites();
+
+    // The blocks must be intact.
+    auto stats = mem.statistics();
+    ASSERT(stats.m_avaliable_memory == stats.m_largest_continous_block);
+}
+
+TEST_CASE(memoryallocator_call_sites_full)
+{
+    std::array<uint8_t, 0x1000> heap;
+    std::array<Std::MemoryAllocator::CallSite, 2> call_sites;
+
+    Std::MemoryAllocator mem { { heap.data(), heap.size() } };
+    mem.set_call_site_table({ call_sites.data(), call_sites.size() });
+
+    std::vector<u8*> pointers;
+    for (uptr caller = 0x10001000; caller < 0x10001000 + 4 * 0x10; caller += 0x10)
+        pointers.push_back(mem.allocate(16, true, reinterpret_cast<void*>(caller)));
+
+    ASSERT(mem.unaccounted_allocations() == 2);
+
+    for (u8 *pointer : pointers)
+        mem.deallocate(pointer);
+
+    ASSERT(call_sites[0].m_live_bytes == 0);
+    ASSERT(call_sites[1].m_live_bytes == 0);
+}
+
+TEST_CASE(memoryallocator_trace_buffer_overwrites_oldest)
+{
+    std::array<Std::MemoryTraceRecord, 4> records;
+    Std::MemoryTraceBuffer buffer { { records.data(), records.size() } };
+
+    for (u32 index = 0; index < 10; ++index) {
+        Std::MemoryTraceRecord record {};
+        record.m_timestamp = index;
+        buffer.append(record);
+    }
+
+    ASSERT(buffer.size() == 4);
+    ASSERT(buffer.overwritten() == 6);
+
+    std::array<Std::MemoryTraceRecord, 3> output;
+    ASSERT(buffer.drain({ output.data(), output.size() }) == 3);
+    ASSERT(output[0].m_timestamp == 6);
+    ASSERT(output[1].m_timestamp == 7);
+    ASSERT(output[2].m_timestamp == 8);
+
+    ASSERT(buffer.drain({ output.data(), output.size() }) == 1);
+    ASSERT(output[0].m_timestamp == 9);
+
+    ASSERT(buffer.drain({ output.data(), output.size() }) == 0);
+}
+
+TEST_CASE(memoryallocator_trace_replay_try_expand)
+{
+    std::array<uint8_t, 0x400> heap;
+    std::array<uint8_t, 0x400> replay_heap;
+    std::array<Std::MemoryTraceRecord, 16> records;
+
+    Std::MemoryAllocator mem { { heap.data(), heap.size() } };
+    mem.set_trace_buffer({ records.data(), records.size() });
+
+    u8 *pointer1 = mem.allocate(16);
+    u8 *pointer2 = mem.allocate(16);
+    u8 *pointer3 = mem.allocate(16);
+    mem.deallocate(pointer3);
+
+    // This grows into the block that was just freed, the next allocation has to be placed behind it.
+    ASSERT(mem.try_expand(pointer2, 64));
+    u8 *pointer4 = mem.allocate(16);
+    ASSERT(pointer4 > pointer2 + 64);
+
+    // A failed attempt does not change the heap and is not traced.
+    usize size = mem.trace_buffer().size();
+    ASSERT(!mem.try_expand(pointer1, 64));
+    ASSERT(mem.trace_buffer().size() == size);
+
+    std::array<Std::MemoryTraceRecord, 16> output;
+    usize count = mem.trace_buffer().drain({ output.data(), output.size() });
+
+    // Replay the trace against an empty heap of the same size, every pointer must end up at the same offset.
+    Std::MemoryAllocator replay { { replay_heap.data(), replay_heap.size() } };
+    std::map<u32, u8*> pointers;
+    u32 reallocate_from = 0;
+
+    auto offset = [&](u32 pointer) { return pointer - u32(uptr(heap.data())); };
+
+    using Std::MemoryTraceOperation;
+
+    for (usize index = 0; index < count; ++index) {
+        const Std::MemoryTraceRecord& record = output[index];
+
+        switch (record.m_operation) {
+        case MemoryTraceOperation::Allocate:
+            pointers[record.m_pointer] = replay.allocate(record.m_size);
+            break;
+        case MemoryTraceOperation::Deallocate:
+            replay.deallocate(pointers[record.m_pointer]);
+            pointers.erase(record.m_pointer);
+            break;
+        case MemoryTraceOperation::ReallocateFrom:
+            reallocate_from = record.m_pointer;
+            break;
+        case MemoryTraceOperation::ReallocateTo: {
+            u8 *pointer = pointers[reallocate_from];
+            pointers.erase(reallocate_from);
+            pointers[record.m_pointer] = replay.reallocate(pointer, record.m_size);
+            break;
+        }
+        }
+
+        if (record.m_operation != MemoryTraceOperation::Deallocate && record.m_operation != MemoryTraceOperation::ReallocateFrom)
+            ASSERT(pointers[record.m_pointer] - replay_heap.data() == offset(record.m_pointer));
+    }
+
+    ASSERT(pointers.size() == 3);
+    ASSERT(pointers[u32(uptr(pointer4))] - replay_heap.data() == pointer4 - heap.data());
+
+    mem.deallocate(pointer1);
+    mem.deallocate(pointer2);
+    mem.deallocate(pointer4);
+}
+
 TEST_MAIN();
@@ -0,0 +1,115 @@
+#include <Tests/TestSuite.hpp>
+
+#include <Std/ObjectPool.hpp>
+#include <Std/RefPtr.hpp>
+
+#include <vector>
+#include <set>
+
+struct A {
+    u32 m_value;
+    u8 m_padding[60];
+};
+
+// Pools never give their pages back, thus they are static to keep them reachable.
+
+TEST_CASE(objectpool)
+{
+    static Std::ObjectPool<A> pool;
+
+    auto stats = pool.statistics();
+    ASSERT(stats.m_live_objects == 0);
+    ASSERT(stats.m_page_count == 0);
+
+    void *object1 = pool.allocate(sizeof(A));
+    void *object2 = pool.allocate(sizeof(A));
+
+    ASSERT(object1 != object2);
+    ASSERT(uptr(object1) % alignof(A) == 0);
+    ASSERT(uptr(object2) % alignof(A) == 0);
+
+    stats = pool.statistics();
+    ASSERT(stats.m_live_objects == 2);
+    ASSERT(stats.m_page_count == 1);
+    ASSERT(stats.m_free_objects == pool.objects_per_page() - 2);
+
+    // Freed objects are reused immediately.
+    pool.deallocate(object1, sizeof(A));
+    ASSERT(pool.allocate(sizeof(A)) == object1);
+
+    pool.deallocate(object1, sizeof(A));
+    pool.deallocate(object2, sizeof(A));
+
+    stats = pool.statistics();
+    ASSERT(stats.m_live_objects == 0);
+    ASSERT(stats.m_peak_objects == 2);
+    ASSERT(stats.m_allocations == 3);
+}
+
+TEST_CASE(objectpool_grows)
+{
+    static Std::ObjectPool<A> pool;
+
+    usize count = 3 * pool.objects_per_page() + 1;
+
+    std::vector<void*> objects;
+    for (usize index = 0; index < count; ++index) {
+        objects.push_back(pool.allocate(sizeof(A)));
+
+        // The object must be usable.
+        new (objects.back()) A { u32(index), {} };
+    }
+
+    std::set<void*> unique_objects { objects.begin(), objects.end() };
+    ASSERT(unique_objects.size() == count);
+
+    for (usize index = 0; index < count; ++index)
+        ASSERT(reinterpret_cast<A*>(objects[index])->m_value == index);
+
+    auto stats = pool.statistics();
+    ASSERT(stats.m_page_count == 4);
+    ASSERT(stats.m_live_objects == count);
+
+    for (void *object : objects)
+        pool.deallocate(object, sizeof(A));
+
+    // No new pages are needed when the objects are allocated again.
+    for (usize index = 0; index < count; ++index)
+        pool.allocate(sizeof(A));
+
+    stats = pool.statistics();
+    ASSERT(stats.m_page_count == 4);
+    ASSERT(stats.m_peak_objects == count);
+}
+
+struct B : Tests::Tracker, Std::RefCounted<B>, Std::PoolAllocated<B> {
+    B() : Tests::Tracker() { }
+};
+
+struct C : B {
+    u8 m_data[64];
+};
+
+TEST_CASE(objectpool_operator_new)
+{
+    Tests::Tracker::clear();
+
+    {
+        auto object1 = B::construct();
+        auto object2 = B::construct();
+
+        ASSERT(B::object_pool().statistics().m_live_objects == 2);
+    }
+
+    Tests::Tracker::assert(2, 0, 0, 2);
+    ASSERT(B::object_pool().statistics().m_live_objects == 0);
+
+    // Derived classes have a different size, they are not allocated from the pool.
+    {
+        Std::RefPtr<C> object { *new C, Std::DanglingObjectMarker{} };
+        ASSERT(B::object_pool().statistics().m_live_objects == 0);
+    }
+    ASSERT(B::object_pool().statistics().m_allocations == 2);
+}
+
+TEST_MAIN();
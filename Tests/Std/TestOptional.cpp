@@ -1,6 +1,8 @@
 #include <Tests/TestSuite.hpp>
 
 #include <Std/Optional.hpp>
+#include <Std/RefPtr.hpp>
+#include <Std/OwnPtr.hpp>
 
 TEST_CASE(optional)
 {
@@ -126,4 +128,70 @@ TEST_CASE(optional_does_not_return_dangling_reference)
     ASSERT(opt2->m_initialized);
 }
 
+TEST_CASE(optional_niche_pointer)
+{
+    static_assert(sizeof(Std::Optional<int*>) == sizeof(int*));
+    static_assert(sizeof(Std::Optional<u32>) > sizeof(u32));
+
+    int value = 42;
+
+    Std::Optional<int*> opt;
+    ASSERT(!opt.is_valid());
+
+    // The null pointer is a value.
+    opt = nullptr;
+    ASSERT(opt.is_valid());
+    ASSERT(opt.must() == nullptr);
+
+    opt = &value;
+    ASSERT(*opt.must() == 42);
+
+    Std::Optional<int*> copy = opt;
+    ASSERT(copy.must() == &value);
+
+    opt.clear();
+    ASSERT(!opt.is_valid());
+    ASSERT(copy.is_valid());
+}
+
+struct Counted : Tests::Tracker, Std::RefCounted<Counted> {
+    Counted() : Tests::Tracker() { }
+};
+
+TEST_CASE(optional_niche_refptr)
+{
+    static_assert(sizeof(Std::Optional<Std::RefPtr<Counted>>) == sizeof(Counted*));
+    static_assert(sizeof(Std::Optional<Std::OwnPtr<int>>) == sizeof(int*));
+
+    Tests::Tracker::clear();
+
+    {
+        Std::Optional<Std::RefPtr<Counted>> opt1;
+        ASSERT(!opt1.is_valid());
+
+        opt1 = Counted::construct();
+        ASSERT(opt1.is_valid());
+        ASSERT(opt1.value()->refcount() == 1);
+
+        Std::Optional<Std::RefPtr<Counted>> opt2 = opt1;
+        ASSERT(opt1.value()->refcount() == 2);
+
+        Std::Optional<Std::RefPtr<Counted>> opt3 = move(opt2);
+        ASSERT(!opt2.is_valid());
+        ASSERT(opt1.value()->refcount() == 2);
+
+        opt1.clear();
+        ASSERT(opt3.value()->refcount() == 1);
+
+        // An empty 'RefPtr' is still a value.
+        opt1 = Std::RefPtr<Counted> {};
+        ASSERT(opt1.is_valid());
+        ASSERT(opt1.value().is_null());
+
+        Tests::Tracker::assert(1, 0, 0, 0);
+    }
+
+    Tests::Tracker::assert(1, 0, 0, 1);
+}
+
 TEST_MAIN();
@@ -0,0 +1,110 @@
+#include <Tests/TestSuite.hpp>
+
+#include <Std/PathView.hpp>
+#include <Std/StringBuilder.hpp>
+
+static Std::ImmutableString join(Std::PathView path)
+{
+    Std::StringBuilder builder;
+
+    bool put_slash = path.is_absolute();
+    if (put_slash && path.component_count() == 0)
+        builder.append('/');
+
+    for (Std::StringView component : path.components()) {
+        if (put_slash)
+            builder.append('/');
+        put_slash = true;
+
+        builder.append(component);
+    }
+
+    return builder.string();
+}
+
+static Std::ImmutableString resolve(Std::PathView base, Std::PathView path)
+{
+    Std::StringBuilder builder;
+
+    usize count = 0;
+    Std::PathView::for_each_resolved_component(base, path, [&](Std::StringView component) {
+        builder.append('/');
+        builder.append(component);
+        ++count;
+        return Std::IterationDecision::Continue;
+    });
+
+    if (count == 0)
+        builder.append('/');
+
+    return builder.string();
+}
+
+TEST_CASE(pathview)
+{
+    Std::PathView path { "/foo/bar/baz" };
+    ASSERT(path.is_absolute());
+    ASSERT(path.component_count() == 3);
+
+    auto iterator = path.components();
+    ASSERT(*iterator == "foo");
+    ++iterator;
+    ASSERT(*iterator == "bar");
+    ++iterator;
+    ASSERT(*iterator == "baz");
+    ++iterator;
+    ASSERT(iterator == iterator.end());
+
+    ASSERT(path.filename() == "baz");
+    ASSERT(join(path) == "/foo/bar/baz");
+
+    ASSERT(!Std::PathView { "x" }.is_absolute());
+    ASSERT(Std::PathView { "/" }.component_count() == 0);
+}
+
+TEST_CASE(pathview_normalize)
+{
+    ASSERT(join("//foo///bar/") == "/foo/bar");
+    ASSERT(join("/./foo/./bar/.") == "/foo/bar");
+    ASSERT(join("/foo/../bar") == "/bar");
+    ASSERT(join("/foo/bar/../..") == "/");
+    ASSERT(join("/a/b/../../c/./d/..") == "/c");
+    ASSERT(join("/a/b/c/../x/../../y") == "/a/y");
+
+    // The parent of the root directory is the root directory.
+    ASSERT(join("/../..") == "/");
+    ASSERT(join("/../a/..") == "/");
+
+    ASSERT(join("a/b/..") == "a");
+    ASSERT(join("a/../../b") == "../b");
+    ASSERT(join("../x/../..") == "../..");
+    ASSERT(join(".") == "");
+}
+
+TEST_CASE(pathview_parent)
+{
+    Std::PathView path { "/x/y/../z/w" };
+
+    Std::PathView parent = path.parent();
+    ASSERT(parent.is_absolute());
+    ASSERT(join(parent) == "/x/z");
+    ASSERT(parent.filename() == "z");
+
+    ASSERT(join(parent.parent()) == "/x");
+    ASSERT(join(parent.parent().parent()) == "/");
+
+    ASSERT(join(Std::PathView { "a/b" }.parent()) == "a");
+}
+
+TEST_CASE(pathview_resolve)
+{
+    ASSERT(resolve("/", "bin") == "/bin");
+    ASSERT(resolve("/home/user", "file.txt") == "/home/user/file.txt");
+    ASSERT(resolve("/home/user", "../other/./file.txt") == "/home/other/file.txt");
+    ASSERT(resolve("/home/user", "../../../..") == "/");
+    ASSERT(resolve("/home/user", "/bin/Shell.elf") == "/bin/Shell.elf");
+    ASSERT(resolve("/home/user", ".") == "/home/user");
+    ASSERT(resolve("/", "") == "/");
+}
+
+TEST_MAIN();
@@ -0,0 +1,109 @@
+#include <Tests/TestSuite.hpp>
+
+#include <Std/RingBuffer.hpp>
+
+#include <thread>
+
+TEST_CASE(ringbuffer)
+{
+    Std::RingBuffer<int, 4> buffer;
+
+    ASSERT(buffer.is_empty());
+    ASSERT(buffer.capacity() == 4);
+
+    ASSERT(buffer.try_push(1));
+    ASSERT(buffer.try_push(2));
+    ASSERT(buffer.try_push(3));
+
+    ASSERT(buffer.size() == 3);
+
+    ASSERT(buffer.try_pop().must() == 1);
+    ASSERT(buffer.try_pop().must() == 2);
+    ASSERT(buffer.try_pop().must() == 3);
+
+    ASSERT(!buffer.try_pop().is_valid());
+    ASSERT(buffer.is_empty());
+}
+
+TEST_CASE(ringbuffer_full)
+{
+    Std::RingBuffer<int, 4> buffer;
+
+    for (int value = 0; value < 4; ++value)
+        ASSERT(buffer.try_push(value));
+
+    ASSERT(!buffer.try_push(4));
+    ASSERT(buffer.avaliable() == 0);
+
+    ASSERT(buffer.try_pop().must() == 0);
+    ASSERT(buffer.try_push(4));
+
+    for (int value = 1; value < 5; ++value)
+        ASSERT(buffer.try_pop().must() == value);
+}
+
+TEST_CASE(ringbuffer_batch)
+{
+    Std::RingBuffer<u8, 8> buffer;
+
+    u8 input[] = { 1, 2, 3, 4, 5, 6 };
+    ASSERT(buffer.push_n(Std::ReadonlyBytes { input, 6 }) == 6);
+
+    u8 output[8];
+    ASSERT(buffer.pop_n(Std::Bytes { output, 4 }) == 4);
+    ASSERT(output[0] == 1 && output[3] == 4);
+
+    // This wraps around the end of the storage and is truncated to the avaliable space.
+    ASSERT(buffer.push_n(Std::ReadonlyBytes { input, 6 }) == 6);
+    ASSERT(buffer.push_n(Std::ReadonlyBytes { input, 6 }) == 0);
+
+    ASSERT(buffer.pop_n(Std::Bytes { output, 8 }) == 8);
+    ASSERT(output[0] == 5);
+    ASSERT(output[1] == 6);
+    ASSERT(output[2] == 1);
+    ASSERT(output[7] == 6);
+
+    ASSERT(buffer.pop_n(Std::Bytes { output, 8 }) == 0);
+}
+
+TEST_CASE(ringbuffer_concurrent)
+{
+    Std::RingBuffer<u32, 64> buffer;
+
+    constexpr u32 count = 20000;
+
+    std::thread producer { [&] {
+        u32 values[7];
+        u32 next = 0;
+        while (next < count) {
+            usize size = 0;
+            while (size < 7 && next + size < count) {
+                values[size] = next + size;
+                ++size;
+            }
+
+            usize pushed = buffer.push_n(Std::Span<const u32> { values, size });
+            if (pushed == 0)
+                std::this_thread::yield();
+
+            next += pushed;
+        }
+    } };
+
+    u32 expected = 0;
+    while (expected < count) {
+        u32 values[5];
+        usize size = buffer.pop_n(Std::Span<u32> { values, 5 });
+        if (size == 0)
+            std::this_thread::yield();
+
+        for (usize index = 0; index < size; ++index)
+            ASSERT(values[index] == expected++);
+    }
+
+    producer.join();
+
+    ASSERT(buffer.is_empty());
+}
+
+TEST_MAIN();
@@ -2,6 +2,10 @@
 
 #include <Std/SortedSet.hpp>
 
+#include <random>
+#include <set>
+#include <vector>
+
 TEST_CASE(sortedset)
 {
     Std::SortedSet<int> set;
@@ -30,7 +34,7 @@ TEST_CASE(sortedset_tree)
     set.insert(15);
     set.insert(4);
 
-    ASSERT(Std::ImmutableString::format("{}", set) == "(nil 0x00000001 (0x00000002 0x00000003 (0x00000004 0x00000007 (nil 0x00000009 0x0000000f))))");
+    ASSERT(Std::ImmutableString::format("{}", set) == "(0x00000001 0x00000002 (0x00000003 0x00000004 (0x00000007 0x00000009 0x0000000f)))");
 }
 
 TEST_CASE(sortedset_remove_1)
@@ -72,11 +76,11 @@ TEST_CASE(sortedset_remove_2)
     set.insert(10);
     set.insert(13);
 
-    ASSERT(Std::ImmutableString::format("{}", set) == "(0x00000004 0x00000007 ((0x00000008 0x00000009 0x0000000a) 0x0000000b 0x0000000d))");
+    ASSERT(Std::ImmutableString::format("{}", set) == "(0x00000004 0x00000007 (0x00000008 0x00000009 (0x0000000a 0x0000000b 0x0000000d)))");
 
     set.remove(11);
 
-    ASSERT(Std::ImmutableString::format("{}", set) == "(0x00000004 0x00000007 ((0x00000008 0x00000009 0x0000000a) 0x0000000d nil))");
+    ASSERT(Std::ImmutableString::format("{}", set) == "(0x00000004 0x00000007 (0x00000008 0x00000009 (0x0000000a 0x0000000d nil)))");
 }
 
 TEST_CASE(sortedset_remove_3)
@@ -87,11 +91,11 @@ TEST_CASE(sortedset_remove_3)
     set.insert(2);
     set.insert(3);
 
-    ASSERT(Std::ImmutableString::format("{}", set) == "(nil 0x00000001 (nil 0x00000002 0x00000003))");
+    ASSERT(Std::ImmutableString::format("{}", set) == "(0x00000001 0x00000002 0x00000003)");
 
     set.remove(2);
 
-    ASSERT(Std::ImmutableString::format("{}", set) == "(nil 0x00000001 0x00000003)");
+    ASSERT(Std::ImmutableString::format("{}", set) == "(0x00000001 0x00000003 nil)");
 }
 
 TEST_CASE(sortedset_remove_4)
@@ -102,11 +106,11 @@ TEST_CASE(sortedset_remove_4)
     set.insert(3);
     set.insert(2);
 
-    ASSERT(Std::ImmutableString::format("{}", set) == "(nil 0x00000001 (0x00000002 0x00000003 nil))");
+    ASSERT(Std::ImmutableString::format("{}", set) == "(0x00000001 0x00000002 0x00000003)");
 
     set.remove(3);
 
-    ASSERT(Std::ImmutableString::format("{}", set) == "(nil 0x00000001 0x00000002)");
+    ASSERT(Std::ImmutableString::format("{}", set) == "(0x00000001 0x00000002 nil)");
 }
 
 TEST_CASE(sortedset_remove_5)
@@ -187,7 +191,7 @@ struct A {
 
 template<>
 struct Std::Formatter<A> {
-    static void format(Std::StringBuilder& builder, const A& value)
+    static void format(Std::FormatSink& builder, const A& value)
     {
         builder.appendf("[{}.{}]", value.m_major, value.m_minor);
     }
@@ -202,7 +206,7 @@ TEST_CASE(sortedset_custom_1)
     set.insert({ 1, 4 });
     set.insert({ 1, 2 });
 
-    ASSERT(Std::ImmutableString::format("{}", set) == "([0x00000001.0x00000002] [0x00000001.0x00000003] ([0x00000001.0x00000004] [0x00000004.0x00000006] nil))");
+    ASSERT(Std::ImmutableString::format("{}", set) == "(([0x00000001.0x00000002] [0x00000001.0x00000003] nil) [0x00000001.0x00000004] [0x00000004.0x00000006])");
 }
 
 struct B {
@@ -222,7 +226,7 @@ struct B {
 
 template<>
 struct Std::Formatter<B> {
-    static void format(Std::StringBuilder& builder, const B& value)
+    static void format(Std::FormatSink& builder, const B& value)
     {
         builder.appendf("[{}.{}]", value.m_indicator, value.m_piggyback);
     }
@@ -236,11 +240,11 @@ TEST_CASE(sortedset_custom_2)
     set.insert({ 13, "bar" });
     set.insert({ -4, "x" });
 
-    ASSERT(Std::ImmutableString::format("{}", set) == "(([-0x00000004.x] [0x0000000d.bar] nil) [0x0000002a.foo] nil)");
+    ASSERT(Std::ImmutableString::format("{}", set) == "([-0x00000004.x] [0x0000000d.bar] [0x0000002a.foo])");
 
     set.insert({ 13, "baz" });
 
-    ASSERT(Std::ImmutableString::format("{}", set) == "(([-0x00000004.x] [0x0000000d.baz] nil) [0x0000002a.foo] nil)");
+    ASSERT(Std::ImmutableString::format("{}", set) == "([-0x00000004.x] [0x0000000d.baz] [0x0000002a.foo])");
 
     set.remove({ 13, "y" });
 
@@ -331,4 +335,119 @@ TEST_CASE(sortedset_move)
     ASSERT(iter.is_end());
 }
 
+TEST_CASE(sortedset_random)
+{
+    Std::SortedSet<int> set;
+    std::set<int> reference;
+
+    std::mt19937 prng { 13 };
+
+    for (usize iteration = 0; iteration < 5000; ++iteration) {
+        int value = prng() % 512;
+
+        if (prng() % 3 == 0) {
+            set.remove(value);
+            reference.erase(value);
+        } else {
+            set.insert(value);
+            reference.insert(value);
+        }
+
+        ASSERT(set.size() == reference.size());
+
+        if (iteration % 64 == 0)
+            set.verify_invariants();
+    }
+    set.verify_invariants();
+
+    auto iterator = reference.begin();
+    for (int value : set.inorder())
+        ASSERT(value == *iterator++);
+    ASSERT(iterator == reference.end());
+}
+
+TEST_CASE(sortedset_sorted_input)
+{
+    Std::SortedSet<int> set;
+
+    // This used to degenerate into a list and the destructor recursed once per node.
+    for (int value = 0; value < 100000; ++value)
+        set.insert(value);
+
+    // A red/black tree with n nodes is at most 2 * log2(n + 1) high, thus there are at most log2(n + 1) black nodes on each path.
+    ASSERT(set.verify_invariants() <= 17);
+
+    for (int value = 0; value < 100000; value += 2)
+        set.remove(value);
+
+    ASSERT(set.size() == 50000);
+    set.verify_invariants();
+
+    set.clear();
+    ASSERT(set.size() == 0);
+    ASSERT(set.min() == nullptr);
+}
+
+TEST_CASE(sortedset_bounds)
+{
+    Std::SortedSet<int> set;
+
+    for (int value : { 10, 20, 30, 40, 50 })
+        set.insert(value);
+
+    ASSERT(*set.lower_bound(20) == 20);
+    ASSERT(*set.lower_bound(21) == 30);
+    ASSERT(*set.lower_bound(-5) == 10);
+    ASSERT(set.lower_bound(51).is_end());
+
+    ASSERT(*set.upper_bound(20) == 30);
+    ASSERT(*set.upper_bound(9) == 10);
+    ASSERT(set.upper_bound(50).is_end());
+
+    std::vector<int> values;
+    for (int value : set.range(20, 50))
+        values.push_back(value);
+    ASSERT((values == std::vector<int> { 20, 30, 40 }));
+
+    values.clear();
+    for (int value : set.range(15, 100))
+        values.push_back(value);
+    ASSERT((values == std::vector<int> { 20, 30, 40, 50 }));
+
+    for (int value : set.range(41, 50))
+        ASSERT_NOT_REACHED();
+    for (int value : set.range(50, 20))
+        ASSERT_NOT_REACHED();
+
+    // Iterating from a bound continues up to the end.
+    values.clear();
+    for (int value : set.upper_bound(30))
+        values.push_back(value);
+    ASSERT((values == std::vector<int> { 40, 50 }));
+}
+
+TEST_CASE(sortedset_from_sorted)
+{
+    for (usize size = 0; size < 130; ++size) {
+        std::vector<int> values;
+        for (usize index = 0; index < size; ++index)
+            values.push_back(index * 3);
+
+        auto set = Std::SortedSet<int>::from_sorted({ values.data(), values.size() });
+
+        ASSERT(set.size() == size);
+        set.verify_invariants();
+
+        usize index = 0;
+        for (int value : set.inorder())
+            ASSERT(value == values[index++]);
+        ASSERT(index == size);
+
+        // The tree must remain valid when it is modified.
+        set.insert(1);
+        set.remove(0);
+        set.verify_invariants();
+    }
+}
+
 TEST_MAIN();
@@ -66,4 +66,108 @@ TEST_CASE(span_iterator)
         ASSERT(*iter++ == buffer[index]);
 }
 
+// Every combination of alignment and size around a few words, compared with the byte by byte result.
+TEST_CASE(span_bulk_copy)
+{
+    std::array<u8, 64> source;
+    for (usize index = 0; index < source.size(); ++index)
+        source[index] = u8(index + 1);
+
+    for (usize source_offset = 0; source_offset < 8; ++source_offset) {
+        for (usize destination_offset = 0; destination_offset < 8; ++destination_offset) {
+            for (usize count = 0; count < 40; ++count) {
+                std::array<u8, 64> destination {};
+                Std::copy_bytes(destination.data() + destination_offset, source.data() + source_offset, count);
+
+                for (usize index = 0; index < destination.size(); ++index) {
+                    if (index >= destination_offset && index < destination_offset + count)
+                        ASSERT(destination[index] == source[index - destination_offset + source_offset]);
+                    else
+                        ASSERT(destination[index] == 0);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(span_bulk_fill)
+{
+    for (usize offset = 0; offset < 8; ++offset) {
+        for (usize count = 0; count < 40; ++count) {
+            std::array<u8, 64> buffer {};
+            Std::Bytes { buffer.data() + offset, count }.fill(0xab);
+
+            for (usize index = 0; index < buffer.size(); ++index)
+                ASSERT(buffer[index] == (index >= offset && index < offset + count ? 0xab : 0));
+        }
+    }
+
+    std::array<int, 5> values {};
+    Std::Span<int> { values.data(), values.size() }.fill(-3);
+    for (int value : values)
+        ASSERT(value == -3);
+}
+
+TEST_CASE(span_bulk_compare)
+{
+    std::array<u8, 64> a;
+    std::array<u8, 64> b;
+
+    auto sign = [](int value) { return (value > 0) - (value < 0); };
+
+    for (usize a_offset = 0; a_offset < 8; ++a_offset) {
+        for (usize b_offset = 0; b_offset < 8; ++b_offset) {
+            for (usize count = 0; count < 40; ++count) {
+                for (usize index = 0; index < a.size(); ++index)
+                    a[index] = b[index] = u8(index * 7);
+
+                ASSERT(Std::compare_bytes(a.data() + a_offset, a.data() + a_offset, count) == 0);
+
+                if (count == 0)
+                    continue;
+
+                // Only the last byte differs, the first differing byte decides the result.
+                Std::copy_bytes(b.data() + b_offset, a.data() + a_offset, count);
+                b[b_offset + count - 1] = 0xff;
+                a[a_offset + count - 1] = 0x01;
+
+                ASSERT(sign(Std::compare_bytes(a.data() + a_offset, b.data() + b_offset, count)) == -1);
+                ASSERT(sign(Std::compare_bytes(b.data() + b_offset, a.data() + a_offset, count)) == 1);
+
+                b[b_offset] = u8(a[a_offset] + 1);
+                ASSERT(sign(Std::compare_bytes(a.data() + a_offset, b.data() + b_offset, count)) == -1);
+            }
+        }
+    }
+}
+
+TEST_CASE(span_bulk_find)
+{
+    std::array<u8, 64> buffer;
+
+    for (usize offset = 0; offset < 8; ++offset) {
+        for (usize count = 0; count < 40; ++count) {
+            buffer.fill(0x80);
+            ASSERT(Std::find_byte(buffer.data() + offset, 0x7f, count) == count);
+
+            for (usize position = 0; position < count; ++position) {
+                buffer.fill(0x80);
+                buffer[offset + position] = 0x7f;
+
+                // Matches after the first one and outside of the range must be ignored.
+                if (offset + position + 1 < buffer.size())
+                    buffer[offset + position + 1] = 0x7f;
+                if (offset > 0)
+                    buffer[offset - 1] = 0x7f;
+
+                ASSERT(Std::find_byte(buffer.data() + offset, 0x7f, count) == position);
+            }
+
+            buffer.fill(0x80);
+            buffer[offset + count] = 0;
+            ASSERT(Std::find_byte(buffer.data() + offset, 0, count) == count);
+        }
+    }
+}
+
 TEST_MAIN();
@@ -1,6 +1,7 @@
 #include <Tests/TestSuite.hpp>
 
 #include <Std/String.hpp>
+#include <Std/Vector.hpp>
 
 TEST_CASE(string_compare)
 {
@@ -36,4 +37,103 @@ TEST_CASE(string_copy)
     ASSERT(string_1 == string_3);
 }
 
+TEST_CASE(string_inline)
+{
+    auto& pool = Std::ImmutableStringInstance::object_pool();
+    usize allocations = pool.statistics().m_allocations;
+
+    Std::ImmutableString string_1;
+    Std::ImmutableString string_2{ "bin" };
+    Std::ImmutableString string_3{ "example" };
+
+    ASSERT(string_1.is_inline() && string_1.size() == 0);
+    ASSERT(string_2.is_inline() && string_2.size() == 3);
+    ASSERT(string_3.is_inline() && string_3.size() == 7);
+
+    ASSERT(string_1.cstring()[0] == 0);
+    ASSERT(string_2.view() == "bin");
+    ASSERT(string_3.cstring()[7] == 0);
+    ASSERT(string_3.view() == "example");
+
+    Std::ImmutableString string_4 = string_3;
+    ASSERT(string_4 == string_3);
+    ASSERT(string_4.data() != string_3.data());
+
+    ASSERT(pool.statistics().m_allocations == allocations);
+}
+
+TEST_CASE(string_shared)
+{
+    auto& pool = Std::ImmutableStringInstance::object_pool();
+    usize allocations = pool.statistics().m_allocations;
+    usize live_objects = pool.statistics().m_live_objects;
+
+    Std::ImmutableString string_1{ "example.text" };
+    ASSERT(!string_1.is_inline());
+    ASSERT(string_1.size() == 12);
+    ASSERT(string_1.cstring()[12] == 0);
+
+    // Copies share the instance.
+    Std::ImmutableString string_2 = string_1;
+    ASSERT(string_2.data() == string_1.data());
+
+    ASSERT(pool.statistics().m_allocations == allocations + 1);
+
+    Std::ImmutableString string_3 = move(string_1);
+    ASSERT(string_3.data() == string_2.data());
+    ASSERT(string_1.is_inline() && string_1.size() == 0);
+
+    string_2 = "bin";
+    string_3 = string_2;
+    ASSERT(string_3.view() == "bin");
+
+    // The last reference was dropped.
+    ASSERT(pool.statistics().m_live_objects == live_objects);
+}
+
+TEST_CASE(string_relocate)
+{
+    Std::Vector<Std::ImmutableString> strings;
+
+    for (usize index = 0; index < 64; ++index) {
+        if (index % 2 == 0)
+            strings.append(Std::ImmutableString::format("{}", u32(index)));
+        else
+            strings.append(Std::ImmutableString::format("file{}.txt", u32(index)));
+    }
+
+    // The inline strings must not refer to their old location after the vector grew.
+    for (usize index = 0; index < 64; ++index) {
+        if (index % 2 == 0)
+            ASSERT(strings[index] == Std::ImmutableString::format("{}", u32(index)));
+        else
+            ASSERT(!strings[index].is_inline());
+    }
+}
+
+TEST_CASE(string_static)
+{
+    auto& pool = Std::ImmutableStringInstance::object_pool();
+    usize allocations = pool.statistics().m_allocations;
+
+    static const char name[] = "a-rather-long-file-name.txt";
+
+    auto string_1 = Std::ImmutableString::from_static(name);
+    ASSERT(string_1.is_static());
+    ASSERT(!string_1.is_inline());
+    ASSERT(string_1.data() == name);
+    ASSERT(string_1.size() == sizeof(name) - 1);
+
+    // Copies refer to the same characters.
+    Std::ImmutableString string_2 = string_1;
+    ASSERT(string_2.data() == name);
+    ASSERT(string_2 == Std::ImmutableString { "a-rather-long-file-name.txt" });
+
+    auto string_3 = Std::ImmutableString::from_static("bin");
+    ASSERT(string_3.is_static());
+    ASSERT(string_3 == "bin");
+
+    ASSERT(pool.statistics().m_allocations == allocations + 1);
+}
+
 TEST_MAIN();
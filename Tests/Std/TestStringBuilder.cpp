@@ -4,7 +4,7 @@
 
 template<>
 struct Std::Formatter<std::strong_ordering> {
-    static void format(StringBuilder& builder, std::strong_ordering value)
+    static void format(FormatSink& builder, std::strong_ordering value)
     {
         if (value == std::strong_ordering::equal) {
             builder.append("equal");
@@ -29,7 +29,7 @@ TEST_CASE(stringbuilder)
     builder.append(' ');
     builder.appendf("b{}z", "a");
 
-    ASSERT(string_1.size() == string_1.view().size());
+    ASSERT(builder.size() == builder.view().size());
 
     ASSERT(builder.view() == "foo bar baz");
     ASSERT(builder.string().view() == "foo bar baz");
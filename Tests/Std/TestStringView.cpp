@@ -29,6 +29,12 @@ TEST_CASE(stringview_index_of)
     ASSERT(sv.index_of('0').must() == 0);
     ASSERT(sv.index_of('3').must() == 3);
     ASSERT(sv.index_of('7').is_valid() == false);
+
+    // The view does not have to be terminated.
+    Std::StringView prefix = Std::StringView { "abcdefghijkl" }.trim(5);
+    ASSERT(prefix.index_of('e').must() == 4);
+    ASSERT(prefix.index_of('f').is_valid() == false);
+    ASSERT(prefix.index_of('\0').is_valid() == false);
 }
 
 TEST_CASE(stringview_equal)
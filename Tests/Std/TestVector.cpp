@@ -1,6 +1,10 @@
 #include <Tests/TestSuite.hpp>
 
 #include <Std/Vector.hpp>
+#include <Std/Format.hpp>
+
+#include <chrono>
+#include <cstdio>
 
 TEST_CASE(vector_default)
 {
@@ -129,4 +133,197 @@ TEST_CASE(vector_exceed_inline_capacity)
         ASSERT(vec.data()[i] == i % 13);
 }
 
+TEST_CASE(vector_emplace)
+{
+    Tests::Tracker::clear();
+
+    Std::Vector<Tests::Tracker, 2> vec;
+    vec.emplace(7);
+    vec.emplace();
+
+    Tests::Tracker::assert(2, 0, 0, 0);
+    ASSERT(vec[0].m_value == 7);
+}
+
+TEST_CASE(vector_extend_primitive)
+{
+    Std::Vector<char, 4> vec;
+
+    vec.extend(Std::StringView { "foo" });
+    vec.extend(Std::StringView { "" });
+    vec.extend(Std::StringView { "barbaz" });
+
+    ASSERT(vec.size() == 9);
+    ASSERT(Std::StringView { vec.span() } == "foobarbaz");
+}
+
+template<typename T>
+static void check_insert_remove(auto make)
+{
+    Std::Vector<T, 2> vec;
+
+    vec.insert(0, make(2));
+    vec.insert(0, make(0));
+    vec.insert(1, make(1));
+    vec.insert(3, make(4));
+    vec.insert(3, make(3));
+
+    ASSERT(vec.size() == 5);
+    for (usize index = 0; index < 5; ++index)
+        ASSERT(vec[index] == make(index));
+
+    // Inserting an element of the vector itself.
+    vec.insert(0, vec[4]);
+    ASSERT(vec[0] == make(4) && vec[5] == make(4));
+
+    vec.remove(0);
+    vec.remove(2);
+    vec.remove(3);
+
+    ASSERT(vec.size() == 3);
+    ASSERT(vec[0] == make(0));
+    ASSERT(vec[1] == make(1));
+    ASSERT(vec[2] == make(3));
+}
+
+TEST_CASE(vector_insert_remove)
+{
+    check_insert_remove<int>([](usize value) { return int(value); });
+    check_insert_remove<Std::ImmutableString>([](usize value) { return Std::ImmutableString::format("{}", value); });
+    check_insert_remove<Tests::Tracker>([](usize value) { return Tests::Tracker { int(value) }; });
+}
+
+TEST_CASE(vector_remove_destroys)
+{
+    Std::Vector<Tests::Tracker> vec;
+
+    vec.emplace(1);
+    vec.emplace(2);
+
+    Tests::Tracker::clear();
+
+    vec.remove(1);
+
+    Tests::Tracker::assert(0, 0, 0, 1);
+    ASSERT(vec.size() == 1 && vec[0].m_value == 1);
+}
+
+TEST_CASE(vector_reserve)
+{
+    Std::Vector<int> vec;
+
+    vec.reserve(5);
+    ASSERT(vec.capacity() == 5);
+
+    vec.ensure_capacity(6);
+    ASSERT(vec.capacity() == 8);
+
+    vec.reserve(3);
+    ASSERT(vec.capacity() == 8);
+}
+
+TEST_CASE(vector_shrink_to_fit)
+{
+    Std::Vector<Std::ImmutableString, 2> vec;
+
+    for (usize index = 0; index < 5; ++index)
+        vec.append(Std::ImmutableString::format("{}", u32(index)));
+
+    ASSERT(vec.capacity() == 8);
+
+    vec.shrink_to_fit();
+    ASSERT(vec.capacity() == 5);
+    ASSERT(vec[4] == "0x00000004");
+
+    vec.remove(4);
+    vec.remove(3);
+    vec.remove(2);
+
+    // The remaining elements fit into the inline buffer again.
+    vec.shrink_to_fit();
+    ASSERT(vec.capacity() == 2);
+    ASSERT(vec[0] == "0x00000000" && vec[1] == "0x00000001");
+
+    vec.append("foo");
+    ASSERT(vec.size() == 3 && vec[2] == "foo");
+}
+
+struct Relocatable : Tests::Tracker {
+    using Tests::Tracker::Tracker;
+};
+
+template<>
+struct Std::IsTriviallyRelocatable<Relocatable> : Std::IntegralConstant<bool, true> {
+};
+
+TEST_CASE(vector_relocate_no_move)
+{
+    Std::Vector<Relocatable> vec;
+
+    Tests::Tracker::clear();
+
+    for (int index = 0; index < 100; ++index)
+        vec.emplace(index);
+
+    // Growing the buffer uses 'memcpy' instead of moving each element.
+    Tests::Tracker::assert(100, 0, 0, 0);
+
+    for (int index = 0; index < 100; ++index)
+        ASSERT(vec[index].m_value == index);
+}
+
+template<typename Callback>
+static double measure(Callback callback)
+{
+    auto start = std::chrono::steady_clock::now();
+    callback();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// This is not the kind of environment one would usually benchmark in, but the relative difference is still visible.
+TEST_CASE(vector_benchmark)
+{
+    constexpr usize repetitions = 200;
+
+    Std::StringView text = "/bin/Shell.elf /bin/Example.elf /bin/Editor.elf /dev/tty /example.txt";
+
+    double per_element_time = measure([&] {
+        for (usize repetition = 0; repetition < repetitions; ++repetition) {
+            Std::Vector<char> vec;
+            for (char ch : text.iter())
+                vec.append(ch);
+        }
+    });
+    double bulk_time = measure([&] {
+        for (usize repetition = 0; repetition < repetitions; ++repetition) {
+            Std::Vector<char> vec;
+            vec.extend(text);
+        }
+    });
+
+    struct NotRelocatable {
+        Std::ImmutableString m_string;
+    };
+
+    Std::ImmutableString string = "foo";
+
+    double move_growth_time = measure([&] {
+        for (usize repetition = 0; repetition < repetitions; ++repetition) {
+            Std::Vector<NotRelocatable> vec;
+            for (usize index = 0; index < 64; ++index)
+                vec.append({ string });
+        }
+    });
+    double relocate_growth_time = measure([&] {
+        for (usize repetition = 0; repetition < repetitions; ++repetition) {
+            Std::Vector<Std::ImmutableString> vec;
+            for (usize index = 0; index < 64; ++index)
+                vec.append(string);
+        }
+    });
+
+    std::printf("  append per element: %8.1fus, extend: %8.1fus\n", per_element_time, bulk_time);
+    std::printf("  growth with moves:  %8.1fus, with memcpy: %8.1fus\n", move_growth_time, relocate_growth_time);
+}
+
 TEST_MAIN();
@@ -209,7 +209,7 @@ namespace Tests
 
 template<>
 struct Std::Formatter<Tests::Tracker> {
-    static void format(Std::StringBuilder& builder, const Tests::Tracker& value)
+    static void format(Std::FormatSink& builder, const Tests::Tracker& value)
     {
         builder.appendf("{}", value.m_value);
     }
@@ -0,0 +1,113 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <optional>
+
+#include <fmt/format.h>
+
+#include <Std/MemoryTrace.hpp>
+
+// Reads a captured console log and turns the records that were printed by 'MemoryAllocator::dump_trace' back
+// into MTRACE messages.  Everything else in the log is ignored.
+
+static std::optional<Std::MemoryTraceRecord> decode_record(std::string_view hex)
+{
+    Std::MemoryTraceRecord record;
+
+    if (hex.size() < 2 * sizeof(record))
+        return {};
+
+    auto decode_digit = [](char digit) -> int {
+        if (digit >= '0' && digit <= '9')
+            return digit - '0';
+        if (digit >= 'a' && digit <= 'f')
+            return digit - 'a' + 10;
+        return -1;
+    };
+
+    uint8_t bytes[sizeof(record)];
+    for (size_t index = 0; index < sizeof(record); ++index) {
+        int high = decode_digit(hex[2 * index]);
+        int low = decode_digit(hex[2 * index + 1]);
+
+        if (high < 0 || low < 0)
+            return {};
+
+        bytes[index] = high * 16 + low;
+    }
+
+    std::memcpy(&record, bytes, sizeof(record));
+    return record;
+}
+
+static std::optional<std::string> format_record(const Std::MemoryTraceRecord& record)
+{
+    using Std::MemoryTraceOperation;
+
+    switch (record.m_operation) {
+    case MemoryTraceOperation::Allocate:
+        return fmt::format("MTRACE: @ {:#010x} + {:#010x} {:#010x}", record.m_caller, record.m_pointer, record.m_size);
+    case MemoryTraceOperation::Deallocate:
+        return fmt::format("MTRACE: @ {:#010x} - {:#010x}", record.m_caller, record.m_pointer);
+    case MemoryTraceOperation::ReallocateFrom:
+        return fmt::format("MTRACE: @ {:#010x} < {:#010x}", record.m_caller, record.m_pointer);
+    case MemoryTraceOperation::ReallocateTo:
+        return fmt::format("MTRACE: @ {:#010x} > {:#010x} {:#010x}", record.m_caller, record.m_pointer, record.m_size);
+    }
+
+    return {};
+}
+
+int main(int argc, char **argv)
+{
+    bool print_timestamps = false;
+    const char *input_path = nullptr;
+
+    for (int index = 1; index < argc; ++index) {
+        if (std::strcmp(argv[index], "--timestamps") == 0)
+            print_timestamps = true;
+        else
+            input_path = argv[index];
+    }
+
+    if (input_path == nullptr) {
+        fmt::print(stderr, "usage: {} [--timestamps] <captured-log>\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream input { input_path };
+    if (!input) {
+        fmt::print(stderr, "Can not open '{}'\n", input_path);
+        return 1;
+    }
+
+    size_t line_number = 0;
+    std::string line;
+    while (std::getline(input, line)) {
+        ++line_number;
+
+        size_t offset = line.find(Std::memory_trace_dump_prefix);
+        if (offset == std::string::npos)
+            continue;
+
+        auto hex = std::string_view { line }.substr(offset + std::strlen(Std::memory_trace_dump_prefix));
+
+        auto record = decode_record(hex);
+        std::optional<std::string> message;
+        if (record.has_value())
+            message = format_record(record.value());
+
+        if (!message.has_value()) {
+            fmt::print(stderr, "{}:{}: Invalid record\n", input_path, line_number);
+            continue;
+        }
+
+        if (print_timestamps)
+            fmt::print("[{:>10}us] {}\n", record->m_timestamp, message.value());
+        else
+            fmt::print("{}\n", message.value());
+    }
+
+    return 0;
+}
@@ -0,0 +1,432 @@
+#include "heap.h"
+
+#include <assert.h>
+#include <string.h>
+
+// Blocks start with a header word that contains the size and the flags, the payload follows immediately.
+// Free blocks additionally store the free list links after the header and their size in the last word, this way
+// the previous block can be found when merging.
+
+#define BLOCK_HEADER_SIZE 4
+#define MINIMUM_BLOCK_SIZE 16
+
+#define SMALL_BLOCK_SIZE (1 << HEAP_FIRST_LEVEL_SHIFT)
+
+#define NULL_BLOCK 0xffffffff
+
+#define BLOCK_IS_FREE (1 << 0)
+#define PREVIOUS_BLOCK_IS_FREE (1 << 1)
+#define BLOCK_FLAGS (BLOCK_IS_FREE | PREVIOUS_BLOCK_IS_FREE)
+
+struct block {
+    uint32_t size_and_flags;
+    uint32_t next_free;
+    uint32_t previous_free;
+};
+_Static_assert(sizeof(struct block) + sizeof(uint32_t) <= MINIMUM_BLOCK_SIZE, "free blocks must fit into the minimum block size");
+
+static uint32_t find_first_set(uint32_t value)
+{
+    return __builtin_ctz(value);
+}
+static uint32_t find_last_set(uint32_t value)
+{
+    return 31 - __builtin_clz(value);
+}
+
+static struct block* block(struct heap *heap, uint32_t offset)
+{
+    return (struct block*)(heap->base + offset);
+}
+
+static uint32_t block_size(struct heap *heap, uint32_t offset)
+{
+    return block(heap, offset)->size_and_flags & ~BLOCK_FLAGS;
+}
+static int is_free(struct heap *heap, uint32_t offset)
+{
+    return block(heap, offset)->size_and_flags & BLOCK_IS_FREE;
+}
+static int is_previous_free(struct heap *heap, uint32_t offset)
+{
+    return block(heap, offset)->size_and_flags & PREVIOUS_BLOCK_IS_FREE;
+}
+
+static uint32_t* footer(struct heap *heap, uint32_t offset)
+{
+    return (uint32_t*)(heap->base + offset + block_size(heap, offset) - sizeof(uint32_t));
+}
+
+static char* payload(struct heap *heap, uint32_t offset)
+{
+    return heap->base + offset + BLOCK_HEADER_SIZE;
+}
+static uint32_t usable_size(struct heap *heap, uint32_t offset)
+{
+    return block_size(heap, offset) - BLOCK_HEADER_SIZE;
+}
+
+static uint32_t offset_from_payload(struct heap *heap, void *pointer)
+{
+    assert((char*)pointer >= heap->base + BLOCK_HEADER_SIZE);
+    assert((char*)pointer < heap->base + heap->size);
+
+    return (char*)pointer - heap->base - BLOCK_HEADER_SIZE;
+}
+
+static void set_block_size(struct heap *heap, uint32_t offset, uint32_t size)
+{
+    assert((size & BLOCK_FLAGS) == 0);
+    block(heap, offset)->size_and_flags = size | (block(heap, offset)->size_and_flags & BLOCK_FLAGS);
+}
+
+static void set_previous_free(struct heap *heap, uint32_t offset, int free)
+{
+    if (free)
+        block(heap, offset)->size_and_flags |= PREVIOUS_BLOCK_IS_FREE;
+    else
+        block(heap, offset)->size_and_flags &= ~PREVIOUS_BLOCK_IS_FREE;
+}
+
+static void set_free(struct heap *heap, uint32_t offset, int free)
+{
+    if (free) {
+        block(heap, offset)->size_and_flags |= BLOCK_IS_FREE;
+        *footer(heap, offset) = block_size(heap, offset);
+    } else {
+        block(heap, offset)->size_and_flags &= ~BLOCK_IS_FREE;
+    }
+
+    set_previous_free(heap, offset + block_size(heap, offset), free);
+}
+
+// Returns zero if the request can not be satisfied, no matter how much memory is free.
+static uint32_t adjust_request_size(size_t size)
+{
+    if (size >= (1 << HEAP_MAXIMUM_POWER))
+        return 0;
+
+    size = (size + 3) & ~(size_t)3;
+    size += BLOCK_HEADER_SIZE;
+
+    return size < MINIMUM_BLOCK_SIZE ? MINIMUM_BLOCK_SIZE : size;
+}
+
+static void mapping_insert(uint32_t size, uint32_t *first_level, uint32_t *second_level)
+{
+    if (size < SMALL_BLOCK_SIZE) {
+        *first_level = 0;
+        *second_level = size / (SMALL_BLOCK_SIZE / HEAP_SECOND_LEVEL_COUNT);
+    } else {
+        uint32_t power = find_last_set(size);
+
+        *first_level = power - HEAP_FIRST_LEVEL_SHIFT + 1;
+        *second_level = (size >> (power - HEAP_SECOND_LEVEL_POWER)) ^ HEAP_SECOND_LEVEL_COUNT;
+    }
+}
+
+static int mapping_search(uint32_t size, uint32_t *first_level, uint32_t *second_level)
+{
+    // Round up to the next list, this ensures that every block in that list is large enough.
+    if (size >= SMALL_BLOCK_SIZE)
+        size += (1 << (find_last_set(size) - HEAP_SECOND_LEVEL_POWER)) - 1;
+
+    mapping_insert(size, first_level, second_level);
+
+    return *first_level < HEAP_FIRST_LEVEL_COUNT;
+}
+
+static uint32_t find_suitable_block(struct heap *heap, uint32_t first_level, uint32_t second_level)
+{
+    uint32_t second_level_bitmap = heap->second_level_bitmaps[first_level] & (~0u << second_level);
+
+    if (second_level_bitmap == 0) {
+        uint32_t first_level_bitmap = heap->first_level_bitmap & (~0u << (first_level + 1));
+
+        if (first_level_bitmap == 0)
+            return NULL_BLOCK;
+
+        first_level = find_first_set(first_level_bitmap);
+        second_level_bitmap = heap->second_level_bitmaps[first_level];
+    }
+
+    second_level = find_first_set(second_level_bitmap);
+    return heap->free_lists[first_level][second_level];
+}
+
+static void insert_free_block(struct heap *heap, uint32_t offset)
+{
+    uint32_t first_level, second_level;
+    mapping_insert(block_size(heap, offset), &first_level, &second_level);
+
+    uint32_t head = heap->free_lists[first_level][second_level];
+
+    block(heap, offset)->next_free = head;
+    block(heap, offset)->previous_free = NULL_BLOCK;
+
+    if (head != NULL_BLOCK)
+        block(heap, head)->previous_free = offset;
+
+    heap->free_lists[first_level][second_level] = offset;
+
+    heap->first_level_bitmap |= 1 << first_level;
+    heap->second_level_bitmaps[first_level] |= 1 << second_level;
+}
+
+static void remove_free_block(struct heap *heap, uint32_t offset)
+{
+    uint32_t first_level, second_level;
+    mapping_insert(block_size(heap, offset), &first_level, &second_level);
+
+    uint32_t next = block(heap, offset)->next_free;
+    uint32_t previous = block(heap, offset)->previous_free;
+
+    if (next != NULL_BLOCK)
+        block(heap, next)->previous_free = previous;
+
+    if (previous != NULL_BLOCK) {
+        block(heap, previous)->next_free = next;
+        return;
+    }
+
+    assert(heap->free_lists[first_level][second_level] == offset);
+    heap->free_lists[first_level][second_level] = next;
+
+    if (next == NULL_BLOCK) {
+        heap->second_level_bitmaps[first_level] &= ~(1 << second_level);
+
+        if (heap->second_level_bitmaps[first_level] == 0)
+            heap->first_level_bitmap &= ~(1 << first_level);
+    }
+}
+
+static void split_free_block(struct heap *heap, uint32_t offset, uint32_t size)
+{
+    assert(block_size(heap, offset) >= size);
+
+    uint32_t remaining_size = block_size(heap, offset) - size;
+
+    // If the remainder is too small to hold a free block, it stays part of this block.
+    if (remaining_size < MINIMUM_BLOCK_SIZE)
+        return;
+
+    set_block_size(heap, offset, size);
+
+    uint32_t remainder = offset + size;
+    block(heap, remainder)->size_and_flags = PREVIOUS_BLOCK_IS_FREE;
+    set_block_size(heap, remainder, remaining_size);
+    set_free(heap, remainder, 1);
+
+    insert_free_block(heap, remainder);
+}
+
+static void free_block(struct heap *heap, uint32_t offset)
+{
+    assert(!is_free(heap, offset));
+
+    uint32_t size = block_size(heap, offset);
+
+    // Try to merge on the left
+    if (is_previous_free(heap, offset)) {
+        uint32_t previous_size = *(uint32_t*)(heap->base + offset - sizeof(uint32_t));
+        uint32_t previous = offset - previous_size;
+
+        assert(is_free(heap, previous));
+        remove_free_block(heap, previous);
+
+        offset = previous;
+        size += previous_size;
+    }
+
+    // Try to merge on the right
+    uint32_t next = offset + size;
+    if (is_free(heap, next)) {
+        remove_free_block(heap, next);
+        size += block_size(heap, next);
+    }
+
+    // Since neighbouring free blocks are always merged, the previous block can not be free at this point.
+    block(heap, offset)->size_and_flags = 0;
+    set_block_size(heap, offset, size);
+    set_free(heap, offset, 1);
+
+    insert_free_block(heap, offset);
+}
+
+static void shrink_used_block(struct heap *heap, uint32_t offset, uint32_t size)
+{
+    assert(!is_free(heap, offset));
+    assert(block_size(heap, offset) >= size);
+
+    uint32_t remaining_size = block_size(heap, offset) - size;
+
+    if (remaining_size < MINIMUM_BLOCK_SIZE)
+        return;
+
+    set_block_size(heap, offset, size);
+
+    // The tail becomes a used block of its own, which is then freed normally.
+    // This will merge it with the next block, if that is free.
+    uint32_t remainder = offset + size;
+    block(heap, remainder)->size_and_flags = 0;
+    set_block_size(heap, remainder, remaining_size);
+
+    free_block(heap, remainder);
+}
+
+static int expand_used_block(struct heap *heap, uint32_t offset, uint32_t size)
+{
+    assert(!is_free(heap, offset));
+
+    if (block_size(heap, offset) < size) {
+        uint32_t next = offset + block_size(heap, offset);
+
+        if (!is_free(heap, next) || block_size(heap, offset) + block_size(heap, next) < size)
+            return 0;
+
+        remove_free_block(heap, next);
+
+        set_block_size(heap, offset, block_size(heap, offset) + block_size(heap, next));
+        set_previous_free(heap, offset + block_size(heap, offset), 0);
+    }
+
+    shrink_used_block(heap, offset, size);
+    return 1;
+}
+
+static void account_used_bytes(struct heap *heap, size_t old_size, size_t new_size)
+{
+    heap->used_bytes = heap->used_bytes - old_size + new_size;
+
+    if (heap->used_bytes > heap->peak_used_bytes)
+        heap->peak_used_bytes = heap->used_bytes;
+}
+
+void heap_initialize(struct heap *heap, void *memory, size_t size)
+{
+    assert((uintptr_t)memory % 4 == 0);
+
+    size -= size % 4;
+    assert(size < (1 << HEAP_MAXIMUM_POWER));
+    assert(size >= MINIMUM_BLOCK_SIZE + BLOCK_HEADER_SIZE);
+
+    memset(heap, 0, sizeof(*heap));
+
+    heap->base = memory;
+    heap->size = size;
+
+    for (uint32_t first_level = 0; first_level < HEAP_FIRST_LEVEL_COUNT; ++first_level) {
+        for (uint32_t second_level = 0; second_level < HEAP_SECOND_LEVEL_COUNT; ++second_level)
+            heap->free_lists[first_level][second_level] = NULL_BLOCK;
+    }
+
+    // The last word of the heap is used as a sentinel, it looks like a used block without size.
+    // This way, we never have to check if the next block is beyond the end of the heap.
+    uint32_t sentinel = size - BLOCK_HEADER_SIZE;
+    block(heap, sentinel)->size_and_flags = 0;
+
+    block(heap, 0)->size_and_flags = 0;
+    set_block_size(heap, 0, sentinel);
+    set_free(heap, 0, 1);
+
+    insert_free_block(heap, 0);
+}
+
+void* heap_allocate(struct heap *heap, size_t size)
+{
+    uint32_t adjusted_size = adjust_request_size(size);
+
+    uint32_t first_level, second_level;
+    uint32_t offset = NULL_BLOCK;
+    if (adjusted_size != 0 && mapping_search(adjusted_size, &first_level, &second_level))
+        offset = find_suitable_block(heap, first_level, second_level);
+
+    if (offset == NULL_BLOCK) {
+        ++heap->failed_allocations;
+        return NULL;
+    }
+
+    remove_free_block(heap, offset);
+    split_free_block(heap, offset, adjusted_size);
+
+    set_free(heap, offset, 0);
+
+    account_used_bytes(heap, 0, usable_size(heap, offset));
+    ++heap->live_allocations;
+    ++heap->allocations;
+
+    return payload(heap, offset);
+}
+
+void heap_deallocate(struct heap *heap, void *pointer)
+{
+    if (pointer == NULL)
+        return;
+
+    uint32_t offset = offset_from_payload(heap, pointer);
+
+    account_used_bytes(heap, usable_size(heap, offset), 0);
+    --heap->live_allocations;
+
+    free_block(heap, offset);
+}
+
+void* heap_reallocate(struct heap *heap, void *pointer, size_t size)
+{
+    if (pointer == NULL)
+        return heap_allocate(heap, size);
+
+    uint32_t offset = offset_from_payload(heap, pointer);
+    uint32_t old_size = usable_size(heap, offset);
+
+    uint32_t adjusted_size = adjust_request_size(size);
+    if (adjusted_size == 0) {
+        ++heap->failed_allocations;
+        return NULL;
+    }
+
+    if (expand_used_block(heap, offset, adjusted_size)) {
+        account_used_bytes(heap, old_size, usable_size(heap, offset));
+        return pointer;
+    }
+
+    // The old block is only freed if the new one could be allocated, as required for 'realloc'.
+    void *new_pointer = heap_allocate(heap, size);
+    if (new_pointer == NULL)
+        return NULL;
+
+    memcpy(new_pointer, pointer, old_size);
+    heap_deallocate(heap, pointer);
+
+    return new_pointer;
+}
+
+size_t heap_usable_size(struct heap *heap, void *pointer)
+{
+    if (pointer == NULL)
+        return 0;
+
+    return usable_size(heap, offset_from_payload(heap, pointer));
+}
+
+void heap_statistics(struct heap *heap, struct heap_statistics *statistics)
+{
+    statistics->used_bytes = heap->used_bytes;
+    statistics->peak_used_bytes = heap->peak_used_bytes;
+    statistics->live_allocations = heap->live_allocations;
+    statistics->allocations = heap->allocations;
+    statistics->failed_allocations = heap->failed_allocations;
+
+    statistics->free_bytes = 0;
+    statistics->largest_free_block = 0;
+
+    for (uint32_t offset = 0; block_size(heap, offset) != 0; offset += block_size(heap, offset)) {
+        if (!is_free(heap, offset))
+            continue;
+
+        statistics->free_bytes += usable_size(heap, offset);
+
+        if (usable_size(heap, offset) > statistics->largest_free_block)
+            statistics->largest_free_block = usable_size(heap, offset);
+    }
+}
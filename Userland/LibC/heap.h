@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// This is the allocator behind 'malloc', it uses the same algorithm as 'Std::MemoryAllocator' in the kernel.
+// It only depends on a few freestanding headers, this way it can be compiled and tested on the host.
+
+#define HEAP_SECOND_LEVEL_POWER 3
+#define HEAP_SECOND_LEVEL_COUNT (1 << HEAP_SECOND_LEVEL_POWER)
+
+// Blocks smaller than '1 << HEAP_FIRST_LEVEL_SHIFT' are all put into the first list of the first level.
+#define HEAP_FIRST_LEVEL_SHIFT (HEAP_SECOND_LEVEL_POWER + 2)
+
+// Userland processes only have a few KiB of heap, there is no point in having lists for larger blocks.
+#define HEAP_MAXIMUM_POWER 16
+#define HEAP_FIRST_LEVEL_COUNT (HEAP_MAXIMUM_POWER - HEAP_FIRST_LEVEL_SHIFT + 1)
+
+struct heap_statistics {
+    size_t used_bytes;
+    size_t peak_used_bytes;
+    size_t free_bytes;
+    size_t largest_free_block;
+
+    size_t live_allocations;
+    size_t allocations;
+    size_t failed_allocations;
+};
+
+struct heap {
+    char *base;
+    uint32_t size;
+
+    uint32_t first_level_bitmap;
+    uint32_t second_level_bitmaps[HEAP_FIRST_LEVEL_COUNT];
+    uint32_t free_lists[HEAP_FIRST_LEVEL_COUNT][HEAP_SECOND_LEVEL_COUNT];
+
+    size_t used_bytes;
+    size_t peak_used_bytes;
+    size_t live_allocations;
+    size_t allocations;
+    size_t failed_allocations;
+};
+
+// The memory must be word aligned and smaller than '1 << HEAP_MAXIMUM_POWER' bytes.
+void heap_initialize(struct heap *heap, void *memory, size_t size);
+
+// These return NULL if there is no free block that is large enough.
+void* heap_allocate(struct heap *heap, size_t size);
+void* heap_reallocate(struct heap *heap, void *pointer, size_t size);
+
+void heap_deallocate(struct heap *heap, void *pointer);
+
+// Returns the number of bytes that can be used in an allocated block, this can be larger than the requested size.
+size_t heap_usable_size(struct heap *heap, void *pointer);
+
+void heap_statistics(struct heap *heap, struct heap_statistics *statistics);
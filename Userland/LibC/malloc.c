@@ -1,41 +1,66 @@
 #include <malloc.h>
-#include <stdlib.h>
-#include <assert.h>
-#include <stdio.h>
+#include <string.h>
+
+#include "heap.h"
 
 extern char __heap_start__[];
 extern char __heap_end__[];
 
-// FIXME: Implement a proper malloc.
+static struct heap heap;
+static int heap_is_initialized;
 
-void free(void *pointer)
+static struct heap* the_heap(void)
 {
-}
+    if (!heap_is_initialized) {
+        heap_initialize(&heap, __heap_start__, __heap_end__ - __heap_start__);
+        heap_is_initialized = 1;
+    }
 
-static char *heap;
+    return &heap;
+}
 
-static size_t round_to_word(size_t size)
+void free(void *pointer)
 {
-    if (size % 4 != 0)
-        size = size + 4 - size % 4;
-    return size;
+    heap_deallocate(the_heap(), pointer);
 }
 
 void* malloc(size_t size)
 {
-    if (heap == NULL)
-        heap = __heap_start__;
+    return heap_allocate(the_heap(), size);
+}
 
-    size = round_to_word(size);
+void* calloc(size_t count, size_t size)
+{
+    if (size != 0 && count > (size_t)-1 / size)
+        return NULL;
 
-    heap += size;
+    void *pointer = malloc(count * size);
+    if (pointer != NULL)
+        memset(pointer, 0, count * size);
 
-    char *pointer = heap - size;
-    assert(pointer <= __heap_end__);
     return pointer;
 }
 
 void* realloc(void *pointer, size_t size)
 {
-    return pointer;
+    return heap_reallocate(the_heap(), pointer, size);
+}
+
+size_t malloc_usable_size(void *pointer)
+{
+    return heap_usable_size(the_heap(), pointer);
+}
+
+void malloc_statistics(struct malloc_statistics *statistics)
+{
+    struct heap_statistics stats;
+    heap_statistics(the_heap(), &stats);
+
+    statistics->used_bytes = stats.used_bytes;
+    statistics->peak_used_bytes = stats.peak_used_bytes;
+    statistics->free_bytes = stats.free_bytes;
+    statistics->largest_free_block = stats.largest_free_block;
+    statistics->live_allocations = stats.live_allocations;
+    statistics->allocations = stats.allocations;
+    statistics->failed_allocations = stats.failed_allocations;
 }
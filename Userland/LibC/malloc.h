@@ -4,4 +4,22 @@
 
 void free(void* pointer);
 void* malloc(size_t size);
+void* calloc(size_t count, size_t size);
 void* realloc(void *pointer, size_t size);
+
+size_t malloc_usable_size(void *pointer);
+
+struct malloc_statistics {
+    // Bytes in allocated blocks, this includes the padding of each block.
+    size_t used_bytes;
+    size_t peak_used_bytes;
+
+    size_t free_bytes;
+    size_t largest_free_block;
+
+    size_t live_allocations;
+    size_t allocations;
+    size_t failed_allocations;
+};
+
+void malloc_statistics(struct malloc_statistics *statistics);